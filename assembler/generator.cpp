@@ -19,7 +19,7 @@ std::string AsmGenerator::add_string(const std::string& value) {
 
 void AsmGenerator::visit_lvalue(Expression& n) {
   need_lvalue = true;
-  n.accept(*this);
+  dispatch(*this, n);
   need_lvalue = false;
 }
 
@@ -55,35 +55,35 @@ void AsmGenerator::visit(MainFunction& m) {
     << cmd(Scanf)
     << cmd(label_main, true); // global main
 
-  AsmGlobalDecl a(asm_file);
+  AsmGlobalDecl a(asm_file.raw());
   a.visit(label_fmt_int, "%Ld");
   a.visit(label_fmt_double, "%1.16E");
   a.visit(label_fmt_char, "%c");
   a.visit(label_fmt_new_line, 10);
   for (auto& var : m.getTable().tableVariable) {
-    var->accept(a);
+    dispatch(a, *var);
   }
 
   // set label for function
   for (auto& var : m.getTable().tableFunction) {
-    auto label = getLabelName(var->getSymbolName());
+    auto label = getLabelName(var->getAtom());
     var->setLabel(label);
   }
 
-  stackTable.push(m.getTable());
   asm_file
     << cmd(code)
     << cmd(Label(label_main))
     << Comment("prolog")
     << cmd(PUSH, {RBP})
     << cmd(MOV, {RBP}, {RSP});
-  m.getBody()->accept(*this);
+  dispatch(*this, *m.getBody());
   asm_file
     << Comment("epilog")
     << cmd(MOV, {RSP}, {RBP})
     << cmd(POP, {RBP})
     << cmd(XOR, {RAX}, {RAX})
     << cmd(RET);
+  asm_file.flush();
 
   // function decl
   for (auto& fun : m.getTable().tableFunction) {
@@ -97,7 +97,6 @@ void AsmGenerator::visit(MainFunction& m) {
 
 void AsmGenerator::visit_function(SymFun& fun) {
   auto s = fun.getSignature();
-  stackTable.pushEmpty();
 
   sizeParam = 0;
   uint64_t offsetParam = 16; // begin [* + 16]; ret -> +8
@@ -109,7 +108,6 @@ void AsmGenerator::visit_function(SymFun& fun) {
     (*iter)->setOffset(offsetParam); // pointer for end
     offsetParam += sizeElem;
     sizeParam += sizeElem;
-    stackTable.top().tableVariable.insert(*iter);
     asm_file
       << "\n"
       << Comment((*iter)->getSymbolName() +
@@ -117,8 +115,7 @@ void AsmGenerator::visit_function(SymFun& fun) {
                  std::to_string(offsetParam) + "]");
   }
 
-  auto tableLocal = fun.getTable();
-  stackTable.push(tableLocal);
+  auto& tableLocal = fun.getTable();
 
   uint64_t sizeLocal = tableLocal.sizeVar();
   uint64_t offsetLocal = 0;
@@ -126,7 +123,7 @@ void AsmGenerator::visit_function(SymFun& fun) {
   // set offset local var
   for (auto& e : tableLocal.tableVariable) {
     uint64_t sizeVar = e->size();
-    if (!s->isProcedure() && e->getSymbolName() == fun.getSymbolName()) { // result var
+    if (!s->isProcedure() && e->getAtom() == fun.getAtom()) { // result var
       sizeLocal -= sizeVar; // not local
       e->setOffset(offsetParam);
       asm_file
@@ -152,7 +149,7 @@ void AsmGenerator::visit_function(SymFun& fun) {
 
   for (auto& e : s->getParamList()) {
     if (e->getVarType()->isOpenArray() && e->getSpec() == ParamSpec::NotSpec) {
-      auto array = std::dynamic_pointer_cast<OpenArray>(e->getVarType());
+      auto array = static_cast<OpenArray*>(e->getVarType());
       uint64_t sizeElem = array->getRefType()->size();
       auto _start = getLabel();
       auto _end = getLabel();
@@ -171,16 +168,17 @@ void AsmGenerator::visit_function(SymFun& fun) {
     }
   }
 
-  fun.getBody()->accept(*this);
+  dispatch(*this, *fun.getBody());
   asm_file
     << cmd(MOV, {RSP}, {RBP})
     << cmd(POP, {RBP})
     << cmd(RET, {sizeParam, none});
+  asm_file.flush();
 }
 
 void AsmGenerator::visit(BlockStmt& b) {
   for (auto& e : b.getBlock()) {
-    e->accept(*this);
+    dispatch(*this, *e);
   }
 }
 
@@ -218,16 +216,19 @@ void AsmGenerator::visit(Function& f) {
 }
 
 void AsmGenerator::visit(ForwardFunction& f) {
-  f.getFunction()->accept(*this);
+  dispatch(*this, *f.getFunction());
 }
 
-void AsmGenerator::visit(Variable& v) {
-  if (v.getNodeType()->isProcedureType() &&
-      stackTable.isFunction(v.getSubToken().getString())) {
-    stackTable.findFunction(v.getSubToken().getString())->accept(*this);
-  } else {
-    stackTable.findVar(v.getSubToken().getString())->accept(*this);
+bool AsmGenerator::isFunctionName(Expression& e) {
+  if (e.getKind() != NodeKind::Variable) {
+    return false;
   }
+  auto kind = static_cast<Variable&>(e).getSymbol()->getKind();
+  return kind == NodeKind::Function || kind == NodeKind::ForwardFunction;
+}
+
+void AsmGenerator::visit(Variable& v) {
+  dispatch(*this, *v.getSymbol());
   asm_file
     << Comment("lvalue variable")
     << cmd(LEA, {RAX}, buf_var_name)
@@ -269,8 +270,8 @@ void AsmGenerator::visit(Literal& l) {
 }
 
 void AsmGenerator::visit_arithmetic(BinaryOperation& b) {
-  b.getSubLeft()->accept(*this);
-  b.getSubRight()->accept(*this);
+  dispatch(*this, *b.getSubLeft());
+  dispatch(*this, *b.getSubRight());
   auto t = b.getOp().getTokenType();
   asm_file
     << Comment("arithmetic operation")
@@ -327,8 +328,8 @@ void AsmGenerator::visit_arithmetic(BinaryOperation& b) {
 }
 
 void AsmGenerator::visit_cmp(BinaryOperation& b) {
-  b.getSubLeft()->accept(*this);
-  b.getSubRight()->accept(*this);
+  dispatch(*this, *b.getSubLeft());
+  dispatch(*this, *b.getSubRight());
   auto t = b.getOp().getTokenType();
   asm_file << Comment("cmp operation");
   if (b.getSubRight()->getNodeType()->isDouble()) {
@@ -354,8 +355,8 @@ void AsmGenerator::visit_cmp(BinaryOperation& b) {
 void AsmGenerator::visit_logical(BinaryOperation& b) {
   switch (b.getOp().getTokenType()) {
     case TokenType::Xor: {
-      b.getSubLeft()->accept(*this);
-      b.getSubRight()->accept(*this);
+      dispatch(*this, *b.getSubLeft());
+      dispatch(*this, *b.getSubRight());
       asm_file << Comment("xor operation");
       asm_file
         << cmd(POP, {RBX}) // righ
@@ -366,8 +367,8 @@ void AsmGenerator::visit_logical(BinaryOperation& b) {
     }
     case TokenType::And: {
       if (b.getNodeType()->isInt()) {
-        b.getSubLeft()->accept(*this);
-        b.getSubRight()->accept(*this);
+        dispatch(*this, *b.getSubLeft());
+        dispatch(*this, *b.getSubRight());
         asm_file << Comment("and operation");
         asm_file
           << cmd(POP, {RBX}) // righ
@@ -379,14 +380,14 @@ void AsmGenerator::visit_logical(BinaryOperation& b) {
         auto _false = getLabel();
         auto _true = getLabel();
 
-        b.getSubLeft()->accept(*this);
+        dispatch(*this, *b.getSubLeft());
         asm_file
           << Comment("and boolean operation")
           << cmd(POP, {RAX})
           << cmd(TEST, {RAX}, {RAX})
           << cmd(JZ, {Label(_false)});
 
-        b.getSubRight()->accept(*this);
+        dispatch(*this, *b.getSubRight());
 
         asm_file
           << cmd(POP, {RAX})
@@ -402,8 +403,8 @@ void AsmGenerator::visit_logical(BinaryOperation& b) {
     }
     case TokenType::Or: {
       if (b.getNodeType()->isInt()) {
-        b.getSubLeft()->accept(*this);
-        b.getSubRight()->accept(*this);
+        dispatch(*this, *b.getSubLeft());
+        dispatch(*this, *b.getSubRight());
         asm_file
           << Comment("or operation")
           << cmd(POP, {RBX}) // righ
@@ -415,14 +416,14 @@ void AsmGenerator::visit_logical(BinaryOperation& b) {
         auto _false = getLabel();
         auto _true = getLabel();
 
-        b.getSubLeft()->accept(*this);
+        dispatch(*this, *b.getSubLeft());
         asm_file
           << Comment("or boolean operation")
           << cmd(POP, {RAX})
           << cmd(TEST, {RAX}, {RAX})
           << cmd(JNZ, {Label(_true)});
 
-        b.getSubRight()->accept(*this);
+        dispatch(*this, *b.getSubRight());
 
         asm_file
           << cmd(POP, {RAX})
@@ -478,7 +479,7 @@ void AsmGenerator::visit(BinaryOperation& b) {
 void AsmGenerator::visit(UnaryOperation& u) {
   switch (u.getOp().getTokenType()) {
     case TokenType::Minus: {
-      u.getSubNode()->accept(*this);
+      dispatch(*this, *u.getSubNode());
       asm_file << Comment("unary minus");
       if (u.getNodeType()->isInt()) {
         asm_file
@@ -497,7 +498,7 @@ void AsmGenerator::visit(UnaryOperation& u) {
       return;
     }
     case TokenType::Not: {
-      u.getSubNode()->accept(*this);
+      dispatch(*this, *u.getSubNode());
       if (u.getNodeType()->isBool()) {
         asm_file
           << Comment("boolean not")
@@ -522,9 +523,9 @@ void AsmGenerator::visit(UnaryOperation& u) {
       asm_file << Comment("^");
       if (need_lvalue) {
         need_lvalue = false;
-        u.getSubNode()->accept(*this);
+        dispatch(*this, *u.getSubNode());
       } else {
-        u.getSubNode()->accept(*this);
+        dispatch(*this, *u.getSubNode());
         asm_file
           << cmd(POP, {RAX})
           << cmd(PUSH, {adr(RAX)});
@@ -538,7 +539,7 @@ void AsmGenerator::visit(UnaryOperation& u) {
 }
 
 void AsmGenerator::visit(Pointer& p) {
-  bounds.front()->accept(*this);
+  dispatch(*this, *bounds.front());
   asm_file
     << Comment("compute pointer offset")
     << cmd(POP, {RAX}) // index
@@ -558,8 +559,8 @@ void AsmGenerator::visit(Pointer& p) {
     << cmd(POP, {RCX}) // base
     << cmd(MOV, {RCX}, {adr(RCX, RAX, 1), none})
     << cmd(PUSH, {RCX}); // new base = *(base + index*sizeof)
-  bounds.pop_front();
-  p.getPointerBase()->accept(*this);
+  bounds.erase(bounds.begin());
+  dispatch(*this, *p.getPointerBase());
 }
 
 void AsmGenerator::visit(StaticArray& s) {
@@ -567,22 +568,15 @@ void AsmGenerator::visit(StaticArray& s) {
   auto array_size = s.getBounds().size();
   auto& real_bounds = bounds;
   auto& array_bounds = s.getBounds();
-
-  std::vector<uint64_t> coeff(array_size, 1);
-  long int i_coeff = array_size - 2;
-  for (auto it = s.getBounds().rbegin(); i_coeff != -1 && it != s.getBounds().rend();
-       ++it, --i_coeff) {
-    uint64_t len = it->second - it->first + 1;
-    coeff.at(i_coeff) = coeff.at(i_coeff + 1) * len;
-  }
+  auto& coeff = s.getLayout().strides;
 
   auto it = array_bounds.begin();
-  i_coeff = 0;
+  uint64_t i_coeff = 0;
   asm_file << cmd(PUSH, {(uint64_t) 0});
   for (uint64_t i = 0; i < real_size; ++i, ++i_coeff, ++it) {
     uint64_t begin = it->first;
-    real_bounds.front()->accept(*this);
-    real_bounds.pop_front();
+    dispatch(*this, *real_bounds.front());
+    real_bounds.erase(real_bounds.begin());
 
     asm_file
       << Comment("compute offset for " + std::to_string(i))
@@ -607,12 +601,12 @@ void AsmGenerator::visit(StaticArray& s) {
       << cmd(POP, {RCX}) // base
       << cmd(ADD, {RCX}, {RAX}) // base + index
       << cmd(PUSH, {RCX}); // new_base
-    s.getRefType()->accept(*this);
+    dispatch(*this, *s.getRefType());
   }
 }
 
 void AsmGenerator::visit(OpenArray& o) {
-  bounds.front()->accept(*this);
+  dispatch(*this, *bounds.front());
   asm_file
     << Comment("compute open array offset")
     << cmd(POP, {RAX}) // index
@@ -629,20 +623,20 @@ void AsmGenerator::visit(OpenArray& o) {
     << cmd(POP, {RCX})
     << cmd(LEA, {RCX}, {adr(RCX, RAX, 1), none})
     << cmd(PUSH, {RCX}); // new base = base + index*sizeof
-  bounds.pop_front();
-  bounds.front()->getNodeType()->accept(*this);
+  bounds.erase(bounds.begin());
+  dispatch(*this, *bounds.front()->getNodeType());
 }
 
 void AsmGenerator::visit(ArrayAccess& a) {
   bool lvalue = need_lvalue;
   if (a.getSubNode()->getNodeType()->isPointer()) {
     need_lvalue = false;
-    a.getSubNode()->accept(*this);
+    dispatch(*this, *a.getSubNode());
   } else {
     visit_lvalue(*a.getSubNode());
   }
   bounds = std::move(a.getListIndex());
-  a.getSubNode()->getNodeType()->accept(*this);
+  dispatch(*this, *a.getSubNode()->getNodeType());
   asm_file
     << Comment("push address base[index]")
     << cmd(POP, {RCX}) // index
@@ -654,13 +648,13 @@ void AsmGenerator::visit(ArrayAccess& a) {
   }
 }
 
-void AsmGenerator::visit(Alias& a) { a.getRefType()->accept(*this); }
+void AsmGenerator::visit(Alias& a) { dispatch(*this, *a.getRefType()); }
 
 void AsmGenerator::visit(RecordAccess& r) {
   bool lvalue = need_lvalue;
   visit_lvalue(*r.getSubNode());
   auto record = r.getSubNode()->getNodeType()->getRecord();
-  auto offset = record->offset(r.getField().getString());
+  auto offset = record->offset(r.getField().getAtom());
   asm_file
     << Comment("record access")
     << cmd(POP, {R8}) // add_record
@@ -675,7 +669,7 @@ void AsmGenerator::visit(Cast& c) {
   if (need_lvalue) {
     visit_lvalue(*c.getSubNode());
   } else {
-    c.getSubNode()->accept(*this);
+    dispatch(*this, *c.getSubNode());
   }
 
   if (c.getSubNode()->getNodeType()->isDouble() && c.getNodeType()->isInt()) {
@@ -696,7 +690,7 @@ void AsmGenerator::visit(Cast& c) {
 }
 
 void AsmGenerator::visit(AssignmentStmt& a) {
-  a.getSubRight()->accept(*this);
+  dispatch(*this, *a.getSubRight());
   visit_lvalue(*a.getSubLeft());
   if (a.getSubLeft()->getNodeType()->isTrivial()) {
     auto t = a.getOp().getTokenType();
@@ -756,7 +750,7 @@ void AsmGenerator::visit(AssignmentStmt& a) {
 void AsmGenerator::visit(Read&) {}
 
 void AsmGenerator::visit(Trunc&) {
-  syscall_params.front()->accept(*this);
+  dispatch(*this, *syscall_params.front());
   asm_file
     << cmd(POP, {RAX})
     << cmd(MOVQ, {XMM1, none}, {RAX, none})
@@ -766,7 +760,7 @@ void AsmGenerator::visit(Trunc&) {
 }
 
 void AsmGenerator::visit(Round&) {
-  syscall_params.front()->accept(*this);
+  dispatch(*this, *syscall_params.front());
   asm_file
     << cmd(POP, {RAX})
     << cmd(MOVQ, {XMM1, none}, {RAX, none})
@@ -776,27 +770,27 @@ void AsmGenerator::visit(Round&) {
 }
 
 void AsmGenerator::visit(Succ&) {
-  syscall_params.front()->accept(*this);
+  dispatch(*this, *syscall_params.front());
   asm_file << cmd(INC, {adr(RSP)});
 }
 
 void AsmGenerator::visit(Prev&) {
-  syscall_params.front()->accept(*this);
+  dispatch(*this, *syscall_params.front());
   asm_file << cmd(DEC, {adr(RSP)});
 }
 
 void AsmGenerator::visit(Chr&) {
-  syscall_params.front()->accept(*this);
+  dispatch(*this, *syscall_params.front());
 }
 
 void AsmGenerator::visit(Ord&) {
-  syscall_params.front()->accept(*this);
+  dispatch(*this, *syscall_params.front());
 }
 
 void AsmGenerator::visit(High&) {
   auto& param = syscall_params.front();
   if (param->getNodeType()->isOpenArray()) {
-    uint64_t offset = stackTable.findVar(param->getVarName())->getOffset();
+    uint64_t offset = static_cast<ParamVar*>(static_cast<Variable&>(*param).getSymbol())->getOffset();
     asm_file
       << Comment("High open array")
       << cmd(PUSH, {adr(RBP, offset + 8)});
@@ -818,12 +812,13 @@ void AsmGenerator::visit(Low&) {
 
 void AsmGenerator::visit(Exit& e) {
   if (!e.getReturnType()->isVoid()) {
+    auto result = makeNode<Variable>(
+      Token({}, e.getVar()->getAtom(), e.getVar()->getSymbolName()),
+      e.getReturnType());
+    result->setSymbol(e.getVar(), 0);
     AssignmentStmt c( // result := expr;
-      Token(-1, -1, TokenType::Assignment),
-      std::make_unique<Variable>(
-        Token(-1, -1, TokenType::String,
-              e.getVar()->getSymbolName(), e.getVar()->getSymbolName()),
-        e.getReturnType()),
+      Token({}, TokenType::Assignment),
+      result,
       std::move(syscall_params.front())
     );
     visit(c);
@@ -837,7 +832,7 @@ void AsmGenerator::visit(Exit& e) {
 void AsmGenerator::visit(Write& w) {
   auto params = std::move(syscall_params);
   for (auto& e : params) {
-    e->accept(*this);
+    dispatch(*this, *e);
     if (e->getNodeType()->isString()) {
       asm_file
         << Comment("printf string")
@@ -880,7 +875,7 @@ void AsmGenerator::visit(Write& w) {
 
 void AsmGenerator::visit(FunctionCallStmt& f) {
   isSkipResult = true;
-  f.getSubNode()->accept(*this);
+  dispatch(*this, *f.getSubNode());
   isSkipResult = false;
 }
 
@@ -890,7 +885,7 @@ void AsmGenerator::visit(FunctionCall& f) {
   asm_file << Comment("function call");
   if (f.getSubNode()->getEmbeddedFunction() != nullptr) {
     syscall_params = std::move(f.getListParam());
-    f.getSubNode()->getEmbeddedFunction()->accept(*this);
+    dispatch(*this, *f.getSubNode()->getEmbeddedFunction());
     return;
   } else {
     auto s = f.getSubNode()->getNodeType()->getSignature();
@@ -915,15 +910,15 @@ void AsmGenerator::visit(FunctionCall& f) {
       }
       asm_file << Comment("argument");
       if ((*iterParams)->getSpec() == ParamSpec::NotSpec) {
-        (*iterArgs)->accept(*this);
+        dispatch(*this, **iterArgs);
       } else {
         visit_lvalue(**iterArgs);
       }
     }
-    if (stackTable.isFunction(f.getSubNode()->getNodeType()->getSymbolName())) {
+    if (isFunctionName(*f.getSubNode())) {
       visit_lvalue(*f.getSubNode());
     } else {
-      f.getSubNode()->accept(*this);
+      dispatch(*this, *f.getSubNode());
     }
     asm_file
       << Comment("call function")
@@ -941,17 +936,17 @@ void AsmGenerator::visit(IfStmt& i) {
   auto _else = getLabel();
   auto _endif = getLabel();
   asm_file << Comment("if _else: " + _else + " _endif: " + _endif);
-  i.getCondition()->accept(*this);
+  dispatch(*this, *i.getCondition());
   asm_file
     << cmd(POP, {RAX})
     << cmd(TEST, {RAX}, {RAX})
     << cmd(JZ, {Label(_else)});
-	i.getSubThen()->accept(*this);
+	dispatch(*this, *i.getSubThen());
   asm_file
     << cmd(JMP, {Label(_endif)})
     << cmd(Label(_else));
   if (i.getSubElse() != nullptr) {
-		i.getSubElse()->accept(*this);
+		dispatch(*this, *i.getSubElse());
   }
   asm_file << cmd(Label(_endif));
 }
@@ -963,12 +958,12 @@ void AsmGenerator::visit(WhileStmt& w) {
   loop.push(std::make_pair(_body, _end));
   asm_file
     << cmd(Label(_body));
-  w.getCondition()->accept(*this);
+  dispatch(*this, *w.getCondition());
   asm_file
     << cmd(POP, {RAX})
     << cmd(TEST, {RAX}, {RAX})
     << cmd(JZ, {Label(_end)});
-  w.getSubNode()->accept(*this);
+  dispatch(*this, *w.getSubNode());
   asm_file
     << cmd(JMP, {Label(_body)})
     << cmd(Label(_end));
@@ -985,9 +980,9 @@ void AsmGenerator::visit(ForStmt& f) {
     << Comment("for ")
     << Comment("_body: " + _body + " _continue: " + _continue + " _break: " + _break + " _endfor: " + _end);
   loop.push(std::make_pair(_continue, _break));
-  f.getLow()->accept(*this);
+  dispatch(*this, *f.getLow());
   visit_lvalue(*f.getVar());
-  f.getHigh()->accept(*this);
+  dispatch(*this, *f.getHigh());
   asm_file
     // init
     << cmd(POP, {R13}) // high
@@ -1005,7 +1000,7 @@ void AsmGenerator::visit(ForStmt& f) {
     << cmd(f.getDirect() ? JL : JG, {Label(_end)})
     << cmd(PUSH, {R13})  // high
     << cmd(PUSH, {R14}); // add_var
-  f.getSubNote()->accept(*this);
+  dispatch(*this, *f.getSubNote());
   asm_file
     << cmd(Label(_continue))
     << cmd(POP, {R14}) // add_var
@@ -1035,11 +1030,11 @@ void AsmGenerator::visit(ContinueStmt&) {
 // Global Decl
 
 void AsmGlobalDecl::visit(GlobalVar& v) {
-  v.setLabel(getLabelName(v.getSymbolName()));
+  v.setLabel(getLabelName(v.getAtom()));
   a
     << cmd(bss)
     << Label(v.getLabel()) << ": ";
-  v.getVarType()->accept(*this);
+  dispatch(*this, *v.getVarType());
 }
 
 void AsmGlobalDecl::visit(Double&) { a << RESQ << " 1\n"; }
@@ -1056,7 +1051,7 @@ void AsmGlobalDecl::visit(TPointer&) { a << RESQ << " 1\n"; }
 
 void AsmGlobalDecl::visit(FunctionSignature&) { a << RESQ << " 1\n"; }
 
-void AsmGlobalDecl::visit(Alias& a) { a.getRefType()->accept(*this); }
+void AsmGlobalDecl::visit(Alias& a) { dispatch(*this, *a.getRefType()); }
 
 void AsmGlobalDecl::visit(StaticArray& s) { a << RESB << " " << s.size() << "\n"; }
 
@@ -3,14 +3,17 @@
 #include <sstream>
 #include "visitor.h"
 #include "opcode.h"
+#include "listing.h"
 #include <stack>
 #include <unordered_map>
 
-class AsmGenerator : public Visitor {
+class AsmGenerator final : public Visitor {
  public:
   AsmGenerator(const std::string&);
   ~AsmGenerator() override = default;
 
+  using Visitor::visit;
+
   void visit(Variable&) override;
   void visit(Literal&) override;
 
@@ -63,15 +66,17 @@ class AsmGenerator : public Visitor {
   void visit(Exit&) override;
 
  public:
-  std::ofstream asm_file;
+  AsmListing asm_file;
 
   // for functionCallStmt
   bool isSkipResult = false;
   uint64_t sizeParam = 0;
 
   // for lvalue
-  bool need_lvalue;
+  bool need_lvalue = false;
   void visit_lvalue(Expression&);
+  // callee named by a function, not a procedural variable
+  bool isFunctionName(Expression&);
 
    const std::unordered_map<TokenType, Instruction> arith_i = {
     {TokenType::Plus, ADD},
@@ -114,7 +119,6 @@ class AsmGenerator : public Visitor {
 
   // for variable  - local, global, parameter, function, constant
   Operand buf_var_name;
-  StackTable stackTable;
 
   // for write -> type param
   ListExpr syscall_params;
@@ -140,10 +144,12 @@ class AsmGenerator : public Visitor {
 };
 
 
-class AsmGlobalDecl : public Visitor {
+class AsmGlobalDecl final : public Visitor {
  public:
   AsmGlobalDecl(std::ostream& a) : a(a) {}
 
+  using Visitor::visit;
+
   void visit(Int&) override;
   void visit(Double&) override;
   void visit(Char&) override;
@@ -0,0 +1,810 @@
+#include "ir_lowering.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "generator.h"
+
+namespace {
+
+uint64_t align8(uint64_t size) {
+  return (size + 7) & ~uint64_t(7);
+}
+
+Instruction setInt(IrCond c) {
+  switch (c) {
+    case IrCond::Eq: return SETE;
+    case IrCond::Ne: return SETNE;
+    case IrCond::Lt: return SETL;
+    case IrCond::Le: return SETLE;
+    case IrCond::Gt: return SETG;
+    default: return SETGE;
+  }
+}
+
+Instruction setDouble(IrCond c) {
+  switch (c) {
+    case IrCond::Eq: return SETE;
+    case IrCond::Ne: return SETNE;
+    case IrCond::Lt: return SETB;
+    case IrCond::Le: return SETBE;
+    case IrCond::Gt: return SETA;
+    default: return SETAE;
+  }
+}
+
+Instruction arithmetic(IrOp op) {
+  switch (op) {
+    case IrOp::Add: return ADD;
+    case IrOp::Sub: return SUB;
+    case IrOp::Mul: return IMUL;
+    case IrOp::And: return AND;
+    case IrOp::Or: return OR;
+    case IrOp::Xor: return XOR;
+    case IrOp::Shl: return SHL;
+    case IrOp::Shr: return SHR;
+    case IrOp::FAdd: return ADDSD;
+    case IrOp::FSub: return SUBSD;
+    case IrOp::FMul: return MULSD;
+    default: return DIVSD;
+  }
+}
+
+Instruction jumpInt(IrCond c) {
+  switch (c) {
+    case IrCond::Eq: return JE;
+    case IrCond::Ne: return JNE;
+    case IrCond::Lt: return JL;
+    case IrCond::Le: return JLE;
+    case IrCond::Gt: return JG;
+    default: return JGE;
+  }
+}
+
+Instruction jumpDouble(IrCond c) {
+  switch (c) {
+    case IrCond::Eq: return JE;
+    case IrCond::Ne: return JNE;
+    case IrCond::Lt: return JB;
+    case IrCond::Le: return JBE;
+    case IrCond::Gt: return JA;
+    default: return JAE;
+  }
+}
+
+Instruction negate(Instruction j) {
+  switch (j) {
+    case JE: return JNE;
+    case JNE: return JE;
+    case JL: return JGE;
+    case JGE: return JL;
+    case JLE: return JG;
+    case JG: return JLE;
+    case JB: return JAE;
+    case JAE: return JB;
+    case JBE: return JA;
+    default: return JBE;
+  }
+}
+
+bool isXmm(Register r) {
+  return r >= XMM0;
+}
+
+Operand reg(Register r) {
+  return isXmm(r) ? Operand(r, none) : Operand(r);
+}
+
+} // namespace
+
+IrLowering::IrLowering(const std::string& s) : asm_file(s) {}
+
+void IrLowering::lower(const IrModule& m) {
+  module = &m;
+  asm_file
+    << cmd(Printf) // extern
+    << cmd(Scanf)
+    << cmd(label_main, true); // global main
+
+  AsmGlobalDecl a(asm_file.raw());
+  a.visit(label_fmt_int, "%Ld");
+  a.visit(label_fmt_double, "%1.16E");
+  a.visit(label_fmt_char, "%c");
+  a.visit(label_fmt_new_line, 10);
+  for (auto& g : m.globals) {
+    asm_file
+      << cmd(bss)
+      << Label(getLabelName(g.name)) << ": " << RESB << " " << align8(g.size) << "\n";
+  }
+  strings.clear();
+  for (auto& s : m.strings) {
+    strings.push_back(getStrName());
+    a.visit(strings.back(), s);
+  }
+
+  asm_file << cmd(code);
+  for (auto& f : m.functions) {
+    lowerFunction(f);
+  }
+  module = nullptr;
+}
+
+void IrLowering::lowerFunction(const IrFunction& f) {
+  fn = &f;
+  labels.clear();
+  for (std::size_t b = 0; b < f.blocks.size(); ++b) {
+    labels.push_back(getLabel());
+  }
+
+  RegisterAllocator allocator(f);
+  locations = allocator.getLocations();
+  uses.assign(f.instrs.size(), 0);
+  for (auto& block : f.blocks) {
+    for (auto v : block.instrs) {
+      for (auto a : f.get(v).args) {
+        ++uses[a];
+      }
+    }
+  }
+
+  // the last argument is pushed last and lies nearest to the return address
+  paramOffset.assign(f.params.size(), 0);
+  uint64_t offset = 16;
+  for (std::size_t k = f.params.size(); k-- > 0;) {
+    paramOffset[k] = offset;
+    offset += align8(f.params[k]);
+  }
+  paramBytes = offset - 16;
+
+  uint64_t frame = 0;
+  slotOffset.clear();
+  for (auto size : f.slots) {
+    frame += align8(size);
+    slotOffset.push_back(frame);
+  }
+  spillOffset = frame;
+  frame += 8 * uint64_t(allocator.getSpillSlots());
+  saved = allocator.getCalleeSaved();
+  savedOffset.clear();
+  for (std::size_t k = 0; k < saved.size(); ++k) {
+    frame += 8;
+    savedOffset.push_back(frame);
+  }
+  frame = (frame + 15) & ~uint64_t(15);
+
+  asm_file
+    << cmd(Label(f.isMain ? label_main : getLabelName(f.name)))
+    << Comment("prolog")
+    << cmd(PUSH, {RBP})
+    << cmd(MOV, {RBP}, {RSP});
+  if (frame != 0) {
+    asm_file << cmd(SUB, {RSP}, {frame});
+  }
+  if (!f.isMain) {
+    // arguments may leave the stack unaligned, printf needs it aligned
+    asm_file
+      << cmd(MOV, {RAX}, {~uint64_t(15)})
+      << cmd(AND, {RSP}, {RAX});
+  }
+  for (std::size_t k = 0; k < saved.size(); ++k) {
+    asm_file << cmd(MOV, {adr(RBP, savedOffset[k], true)}, {saved[k]});
+  }
+
+  for (IrBlockId b = 0; b < f.blocks.size(); ++b) {
+    next = b + 1;
+    if (b != 0) {
+      asm_file << cmd(Label(labels[b]));
+    }
+    auto& list = f.blocks[b].instrs;
+    // a compare used only by the branch right after it sets the flags for the jump
+    auto& last = f.get(list.back());
+    fused = false;
+    if (last.op == IrOp::Branch && list.size() >= 2 && list[list.size() - 2] == last.args[0]) {
+      auto op = f.get(last.args[0]).op;
+      fused = (op == IrOp::Cmp || op == IrOp::FCmp) && uses[last.args[0]] == 1;
+    }
+    for (std::size_t k = 0; k + (fused ? 2 : 1) < list.size(); ++k) {
+      lowerInstr(list[k]);
+    }
+    lowerTerminator(b);
+  }
+  asm_file.flush();
+  fn = nullptr;
+}
+
+bool IrLowering::isRemat(IrValue v) const {
+  return isRematerialized(fn->get(v));
+}
+
+bool IrLowering::isImm(IrValue v) const {
+  auto& i = fn->get(v);
+  return i.op == IrOp::Const && i.imm >= 0 && i.imm <= INT32_MAX;
+}
+
+bool IrLowering::inRegister(IrValue v, Register r) const {
+  return !isRemat(v) && locations[v].isReg() && locations[v].reg == r;
+}
+
+Operand IrLowering::operandOf(const Location& l) const {
+  if (l.kind == Location::Stack) {
+    return {adr(RBP, spillOffset + 8 * uint64_t(l.slot + 1), true)};
+  }
+  return reg(l.reg);
+}
+
+void IrLowering::load(Register r, const Location& l) {
+  if (l.isReg() && l.reg == r) {
+    return;
+  }
+  if (isXmm(r)) {
+    asm_file << cmd(l.kind == Location::Gpr ? MOVQ : MOVSD, reg(r), operandOf(l));
+  } else {
+    asm_file << cmd(l.kind == Location::Xmm ? MOVQ : MOV, reg(r), operandOf(l));
+  }
+}
+
+void IrLowering::store(const Location& l, Register r) {
+  if (l.isReg()) {
+    load(l.reg, {isXmm(r) ? Location::Xmm : Location::Gpr, r, 0});
+  } else {
+    asm_file << cmd(isXmm(r) ? MOVSD : MOV, operandOf(l), reg(r));
+  }
+}
+
+void IrLowering::move(const Location& to, const Location& from) {
+  if (to == from) {
+    return;
+  }
+  if (to.isReg()) {
+    load(to.reg, from);
+  } else if (from.isReg()) {
+    store(to, from.reg);
+  } else {
+    load(R11, from);
+    store(to, R11);
+  }
+}
+
+void IrLowering::toGpr(Register r, IrValue v) {
+  auto& i = fn->get(v);
+  switch (i.op) {
+    case IrOp::Const: {
+      asm_file << cmd(MOV, {r}, {static_cast<uint64_t>(i.imm)});
+      break;
+    }
+    case IrOp::ConstDouble: {
+      uint64_t bits;
+      std::memcpy(&bits, &i.number, sizeof(bits));
+      asm_file << cmd(MOV, {r}, {bits});
+      break;
+    }
+    case IrOp::Global:
+    case IrOp::FunctionAddr: {
+      asm_file << cmd(LEA, {r}, {adr(Label(getLabelName(i.name))), none});
+      break;
+    }
+    case IrOp::String: {
+      asm_file << cmd(LEA, {r}, {adr(Label(strings[i.imm])), none});
+      break;
+    }
+    case IrOp::Local: {
+      asm_file << cmd(LEA, {r}, {adr(RBP, slotOffset[i.imm], true), none});
+      break;
+    }
+    case IrOp::Param: {
+      asm_file << cmd(LEA, {r}, {adr(RBP, paramOffset[i.imm]), none});
+      break;
+    }
+    case IrOp::Result: {
+      asm_file << cmd(LEA, {r}, {adr(RBP, 16 + paramBytes), none});
+      break;
+    }
+    default:
+      load(r, locations[v]);
+  }
+}
+
+void IrLowering::toXmm(Register r, IrValue v) {
+  if (!isRemat(v)) {
+    load(r, locations[v]);
+  } else if (fn->get(v).op == IrOp::ConstDouble && fn->get(v).number == 0 && !std::signbit(fn->get(v).number)) {
+    asm_file << cmd(XORPD, reg(r), reg(r));
+  } else {
+    toGpr(RAX, v);
+    asm_file << cmd(MOVQ, reg(r), {RAX});
+  }
+}
+
+void IrLowering::define(IrValue v, Register r) {
+  store(locations[v], r);
+}
+
+Register IrLowering::gprDest(IrValue v) const {
+  return locations[v].kind == Location::Gpr ? locations[v].reg : RAX;
+}
+
+Register IrLowering::xmmDest(IrValue v) const {
+  return locations[v].kind == Location::Xmm ? locations[v].reg : XMM0;
+}
+
+Operand IrLowering::gprSource(IrValue v, Register scratch) {
+  if (isImm(v)) {
+    return {static_cast<uint64_t>(fn->get(v).imm)};
+  }
+  if (!isRemat(v)) {
+    return operandOf(locations[v]);
+  }
+  toGpr(scratch, v);
+  return {scratch};
+}
+
+Operand IrLowering::xmmSource(IrValue v, Register scratch) {
+  if (!isRemat(v)) {
+    return operandOf(locations[v]);
+  }
+  toXmm(scratch, v);
+  return reg(scratch);
+}
+
+Operand IrLowering::memOf(IrValue address, Register scratch) {
+  auto& i = fn->get(address);
+  switch (i.op) {
+    case IrOp::Global: return {adr(Label(getLabelName(i.name)))};
+    case IrOp::Local: return {adr(RBP, slotOffset[i.imm], true)};
+    case IrOp::Param: return {adr(RBP, paramOffset[i.imm])};
+    case IrOp::Result: return {adr(RBP, 16 + paramBytes)};
+    default:
+      if (!isRemat(address) && locations[address].kind == Location::Gpr) {
+        return {adr(locations[address].reg)};
+      }
+      toGpr(scratch, address);
+      return {adr(scratch)};
+  }
+}
+
+void IrLowering::lowerInstr(IrValue v) {
+  auto& i = fn->get(v);
+  if (isRemat(v)) {
+    return;
+  }
+  switch (i.op) {
+    case IrOp::Load: {
+      auto m = memOf(i.args[0], R11);
+      auto r = i.type == IrType::Double ? xmmDest(v) : gprDest(v);
+      asm_file << cmd(isXmm(r) ? MOVSD : MOV, reg(r), m);
+      define(v, r);
+      break;
+    }
+    case IrOp::Store: {
+      auto m = memOf(i.args[0], R11);
+      auto value = i.args[1];
+      if (isImm(value)) {
+        asm_file << cmd(MOV, m, {static_cast<uint64_t>(fn->get(value).imm)});
+      } else if (!isRemat(value) && locations[value].isReg()) {
+        auto r = locations[value].reg;
+        asm_file << cmd(isXmm(r) ? MOVSD : MOV, m, reg(r));
+      } else {
+        toGpr(RAX, value);
+        asm_file << cmd(MOV, m, {RAX});
+      }
+      break;
+    }
+    case IrOp::MemCopy: {
+      toGpr(RDI, i.args[0]);
+      toGpr(RSI, i.args[1]);
+      asm_file
+        << cmd(MOV, {RCX}, {static_cast<uint64_t>(i.imm)})
+        << cmd(REP, MOVSB);
+      break;
+    }
+    case IrOp::Add:
+    case IrOp::Sub:
+    case IrOp::Mul:
+    case IrOp::And:
+    case IrOp::Or:
+    case IrOp::Xor: {
+      auto a = i.args[0];
+      auto b = i.args[1];
+      auto r = gprDest(v);
+      // the destination must not overwrite the right operand before it is read
+      if (a != b && inRegister(b, r)) {
+        if (i.op == IrOp::Sub) {
+          r = RAX;
+        } else {
+          std::swap(a, b);
+        }
+      }
+      toGpr(r, a);
+      asm_file << cmd(arithmetic(i.op), {r}, gprSource(b, RCX));
+      define(v, r);
+      break;
+    }
+    case IrOp::Div:
+    case IrOp::Mod: {
+      // idiv takes no immediate
+      Operand divisor = {RCX};
+      if (isRemat(i.args[1])) {
+        toGpr(RCX, i.args[1]);
+      } else {
+        divisor = operandOf(locations[i.args[1]]);
+      }
+      toGpr(RAX, i.args[0]);
+      asm_file
+        << cmd(CQO)
+        << cmd(IDIV, divisor);
+      define(v, i.op == IrOp::Div ? RAX : RDX);
+      break;
+    }
+    case IrOp::Shl:
+    case IrOp::Shr: {
+      auto r = gprDest(v);
+      if (isImm(i.args[1]) && fn->get(i.args[1]).imm < 64) {
+        toGpr(r, i.args[0]);
+        asm_file << cmd(arithmetic(i.op), {r}, {static_cast<uint64_t>(fn->get(i.args[1]).imm), none});
+      } else {
+        toGpr(RCX, i.args[1]);
+        toGpr(r, i.args[0]);
+        asm_file << cmd(arithmetic(i.op), {r}, {CL, Pref::b});
+      }
+      define(v, r);
+      break;
+    }
+    case IrOp::Neg:
+    case IrOp::Not: {
+      auto r = gprDest(v);
+      toGpr(r, i.args[0]);
+      asm_file << cmd(i.op == IrOp::Neg ? NEG : NOT, {r});
+      define(v, r);
+      break;
+    }
+    case IrOp::FAdd:
+    case IrOp::FSub:
+    case IrOp::FMul:
+    case IrOp::FDiv: {
+      auto a = i.args[0];
+      auto b = i.args[1];
+      auto r = xmmDest(v);
+      if (a != b && inRegister(b, r)) {
+        if (i.op == IrOp::FSub || i.op == IrOp::FDiv) {
+          r = XMM0;
+        } else {
+          std::swap(a, b);
+        }
+      }
+      toXmm(r, a);
+      asm_file << cmd(arithmetic(i.op), reg(r), xmmSource(b, XMM1));
+      define(v, r);
+      break;
+    }
+    case IrOp::Cmp: {
+      auto r = gprDest(v);
+      lowerCompare(i);
+      asm_file
+        << cmd(setInt(static_cast<IrCond>(i.imm)), {AL, none})
+        << cmd(MOVZX, {r}, {AL, none});
+      define(v, r);
+      break;
+    }
+    case IrOp::FCmp: {
+      auto r = gprDest(v);
+      lowerCompare(i);
+      asm_file
+        << cmd(setDouble(static_cast<IrCond>(i.imm)), {AL, none})
+        << cmd(MOVZX, {r}, {AL, none});
+      define(v, r);
+      break;
+    }
+    case IrOp::IntToDouble: {
+      auto r = xmmDest(v);
+      Operand source = {RAX};
+      if (isRemat(i.args[0])) {
+        toGpr(RAX, i.args[0]);
+      } else {
+        source = operandOf(locations[i.args[0]]);
+      }
+      asm_file << cmd(CVTSI2SD, reg(r), source);
+      define(v, r);
+      break;
+    }
+    case IrOp::DoubleToInt: {
+      auto r = gprDest(v);
+      asm_file << cmd(CVTSD2SI, {r}, xmmSource(i.args[0], XMM0));
+      define(v, r);
+      break;
+    }
+    case IrOp::RoundToInt: {
+      auto r = gprDest(v);
+      asm_file
+        << cmd(ROUNDSD, {XMM0, none}, xmmSource(i.args[0], XMM1), {static_cast<uint64_t>(i.imm), none})
+        << cmd(CVTSD2SI, {r}, {XMM0, none});
+      define(v, r);
+      break;
+    }
+    case IrOp::Call: {
+      lowerCall(v);
+      break;
+    }
+    case IrOp::Print: {
+      lowerPrint(i);
+      break;
+    }
+    case IrOp::OpenArrayCopy: {
+      lowerOpenArrayCopy(i);
+      break;
+    }
+    default:
+      break; // phis are copied on the edges
+  }
+}
+
+void IrLowering::lowerCompare(const IrInstr& i) {
+  auto a = i.args[0];
+  auto b = i.args[1];
+  if (i.op == IrOp::Cmp) {
+    Register lhs = RCX;
+    if (!isRemat(a) && locations[a].kind == Location::Gpr) {
+      lhs = locations[a].reg;
+    } else {
+      toGpr(RCX, a);
+    }
+    asm_file << cmd(CMP, {lhs}, gprSource(b, RDX));
+  } else {
+    Register lhs = XMM0;
+    if (!isRemat(a) && locations[a].kind == Location::Xmm) {
+      lhs = locations[a].reg;
+    } else {
+      toXmm(XMM0, a);
+    }
+    asm_file << cmd(COMISD, reg(lhs), xmmSource(b, XMM1));
+  }
+}
+
+void IrLowering::lowerCall(IrValue v) {
+  auto& i = fn->get(v);
+  bool hasDest = i.type == IrType::Void && i.imm > 0;
+  std::size_t end = i.args.size() - (hasDest ? 1 : 0);
+  uint64_t sizeReturn = align8(i.imm);
+
+  asm_file << Comment("function call");
+  if (sizeReturn != 0) {
+    asm_file << cmd(SUB, {RSP}, {sizeReturn});
+  }
+  for (std::size_t k = 1; k < end; ++k) {
+    auto arg = i.args[k];
+    auto size = i.argSize[k - 1];
+    if (size != 0) {
+      toGpr(RSI, arg);
+      asm_file
+        << cmd(SUB, {RSP}, {align8(size)})
+        << cmd(MOV, {RDI}, {RSP})
+        << cmd(MOV, {RCX}, {size})
+        << cmd(REP, MOVSB);
+    } else if (!isRemat(arg) && locations[arg].kind == Location::Xmm) {
+      asm_file
+        << cmd(SUB, {RSP}, {(uint64_t)8})
+        << cmd(MOVSD, {adr(RSP)}, reg(locations[arg].reg));
+    } else if (isImm(arg) || !isRemat(arg)) {
+      asm_file << cmd(PUSH, gprSource(arg, RAX));
+    } else {
+      toGpr(RAX, arg);
+      asm_file << cmd(PUSH, {RAX});
+    }
+  }
+
+  auto& callee = fn->get(i.args[0]);
+  if (callee.op == IrOp::FunctionAddr) {
+    asm_file << cmd(CALL, {Label(getLabelName(callee.name))});
+  } else {
+    asm_file << cmd(CALL, gprSource(i.args[0], RAX));
+  }
+
+  if (hasDest) {
+    toGpr(RDI, i.args.back());
+    asm_file
+      << cmd(MOV, {RSI}, {RSP})
+      << cmd(MOV, {RCX}, {static_cast<uint64_t>(i.imm)})
+      << cmd(REP, MOVSB);
+  } else if (i.type != IrType::Void) {
+    auto r = i.type == IrType::Double ? xmmDest(v) : gprDest(v);
+    asm_file << cmd(isXmm(r) ? MOVSD : MOV, reg(r), {adr(RSP)});
+    define(v, r);
+  }
+  if (sizeReturn != 0) {
+    asm_file << cmd(ADD, {RSP}, {sizeReturn});
+  }
+}
+
+void IrLowering::lowerPrint(const IrInstr& i) {
+  switch (static_cast<IrFormat>(i.imm)) {
+    case IrFormat::Int:
+    case IrFormat::Char: {
+      toGpr(RSI, i.args[0]);
+      auto& label = static_cast<IrFormat>(i.imm) == IrFormat::Int ? label_fmt_int : label_fmt_char;
+      asm_file
+        << cmd(MOV, {RDI}, {Label(label)})
+        << cmd(XOR, {RAX}, {RAX});
+      break;
+    }
+    case IrFormat::Double: {
+      toXmm(XMM0, i.args[0]);
+      asm_file
+        << cmd(MOV, {RDI}, {Label(label_fmt_double)})
+        << cmd(MOV, {RAX}, {(uint64_t)1});
+      break;
+    }
+    case IrFormat::String: {
+      toGpr(RDI, i.args[0]);
+      asm_file << cmd(XOR, {RAX}, {RAX});
+      break;
+    }
+    case IrFormat::NewLine: {
+      asm_file
+        << cmd(MOV, {RDI}, {Label(label_fmt_new_line)})
+        << cmd(XOR, {RAX}, {RAX});
+      break;
+    }
+  }
+  asm_file << cmd(CALL, {Printf});
+}
+
+void IrLowering::lowerOpenArrayCopy(const IrInstr& i) {
+  // (high + 1) * size bytes below the frame, the parameter points to the copy
+  toGpr(R11, i.args[0]);
+  asm_file
+    << Comment("copy open array")
+    << cmd(MOV, {RCX}, {adr(R11, 8)})
+    << cmd(ADD, {RCX}, {(uint64_t)1})
+    << cmd(IMUL, {RCX}, {static_cast<uint64_t>(i.imm)})
+    << cmd(MOV, {RAX}, {RCX})
+    << cmd(ADD, {RAX}, {(uint64_t)15})
+    << cmd(MOV, {RDX}, {~uint64_t(15)})
+    << cmd(AND, {RAX}, {RDX})
+    << cmd(SUB, {RSP}, {RAX})
+    << cmd(MOV, {RSI}, {adr(R11)})
+    << cmd(MOV, {RDI}, {RSP})
+    << cmd(MOV, {adr(R11)}, {RSP})
+    << cmd(REP, MOVSB);
+}
+
+bool IrLowering::hasPhi(IrBlockId b) const {
+  auto& list = fn->blocks[b].instrs;
+  return !list.empty() && fn->get(list.front()).op == IrOp::Phi;
+}
+
+void IrLowering::phiCopies(IrBlockId from, IrBlockId to) {
+  struct Copy {
+    Location to;
+    Location from;
+  };
+  std::vector<Copy> copies;
+  std::vector<std::pair<Location, IrValue>> rebuilt;
+  for (auto v : fn->blocks[to].instrs) {
+    auto& phi = fn->get(v);
+    if (phi.op != IrOp::Phi) {
+      break;
+    }
+    for (std::size_t k = 0; k < phi.args.size(); ++k) {
+      if (phi.from[k] != from) {
+        continue;
+      }
+      auto arg = phi.args[k];
+      if (isRemat(arg)) {
+        rebuilt.push_back({locations[v], arg});
+      } else if (locations[arg] != locations[v]) {
+        copies.push_back({locations[v], locations[arg]});
+      }
+      break;
+    }
+  }
+
+  // the copies are parallel: a location is written once nothing reads it
+  // any more, a cycle is broken through a scratch register
+  while (!copies.empty()) {
+    auto ready = std::find_if(copies.begin(), copies.end(), [&](const Copy& c) {
+      return std::none_of(copies.begin(), copies.end(), [&](const Copy& o) { return o.from == c.to; });
+    });
+    if (ready != copies.end()) {
+      move(ready->to, ready->from);
+      copies.erase(ready);
+      continue;
+    }
+    auto blocked = copies.front().to;
+    Location scratch = blocked.kind == Location::Xmm
+      ? Location{Location::Xmm, XMM0, 0}
+      : Location{Location::Gpr, RAX, 0};
+    move(scratch, blocked);
+    for (auto& c : copies) {
+      if (c.from == blocked) {
+        c.from = scratch;
+      }
+    }
+  }
+  for (auto& [location, value] : rebuilt) {
+    if (location.kind == Location::Xmm) {
+      toXmm(location.reg, value);
+    } else if (location.kind == Location::Gpr) {
+      toGpr(location.reg, value);
+    } else if (isImm(value)) {
+      asm_file << cmd(MOV, operandOf(location), {static_cast<uint64_t>(fn->get(value).imm)});
+    } else {
+      toGpr(RAX, value);
+      store(location, RAX);
+    }
+  }
+}
+
+void IrLowering::lowerEpilogue() {
+  asm_file << Comment("epilog");
+  for (std::size_t k = 0; k < saved.size(); ++k) {
+    asm_file << cmd(MOV, {saved[k]}, {adr(RBP, savedOffset[k], true)});
+  }
+  asm_file
+    << cmd(MOV, {RSP}, {RBP})
+    << cmd(POP, {RBP});
+  if (fn->isMain) {
+    asm_file
+      << cmd(XOR, {RAX}, {RAX})
+      << cmd(RET);
+  } else if (paramBytes != 0) {
+    asm_file << cmd(RET, {paramBytes, none});
+  } else {
+    asm_file << cmd(RET);
+  }
+}
+
+void IrLowering::lowerTerminator(IrBlockId b) {
+  auto& block = fn->blocks[b];
+  auto& i = fn->get(block.instrs.back());
+  switch (i.op) {
+    case IrOp::Jump: {
+      auto to = block.succs[0];
+      phiCopies(b, to);
+      if (to != next) {
+        asm_file << cmd(JMP, {Label(labels[to])});
+      }
+      break;
+    }
+    case IrOp::Branch: {
+      auto ifTrue = block.succs[0];
+      auto ifFalse = block.succs[1];
+      Instruction jumpTrue = JNZ;
+      Instruction jumpFalse = JZ;
+      auto& cond = fn->get(i.args[0]);
+      if (fused) {
+        lowerCompare(cond);
+        auto c = static_cast<IrCond>(cond.imm);
+        jumpTrue = cond.op == IrOp::Cmp ? jumpInt(c) : jumpDouble(c);
+        jumpFalse = negate(jumpTrue);
+      } else if (!isRemat(i.args[0]) && locations[i.args[0]].kind == Location::Gpr) {
+        auto r = locations[i.args[0]].reg;
+        asm_file << cmd(TEST, {r}, {r});
+      } else {
+        toGpr(RAX, i.args[0]);
+        asm_file << cmd(TEST, {RAX}, {RAX});
+      }
+      if (hasPhi(ifTrue) || hasPhi(ifFalse)) {
+        auto edge = getLabel();
+        asm_file << cmd(jumpFalse, {Label(edge)});
+        phiCopies(b, ifTrue);
+        asm_file
+          << cmd(JMP, {Label(labels[ifTrue])})
+          << cmd(Label(edge));
+        phiCopies(b, ifFalse);
+        if (ifFalse != next) {
+          asm_file << cmd(JMP, {Label(labels[ifFalse])});
+        }
+      } else if (ifTrue == next) {
+        asm_file << cmd(jumpFalse, {Label(labels[ifFalse])});
+      } else {
+        asm_file << cmd(jumpTrue, {Label(labels[ifTrue])});
+        if (ifFalse != next) {
+          asm_file << cmd(JMP, {Label(labels[ifFalse])});
+        }
+      }
+      break;
+    }
+    default:
+      lowerEpilogue();
+  }
+}
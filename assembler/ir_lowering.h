@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "ir.h"
+#include "listing.h"
+#include "opcode.h"
+#include "register_allocator.h"
+
+// Translates the IR to nasm. A value an instruction computes lives where
+// RegisterAllocator put it; constants and addresses of variables are rebuilt
+// where they are used. Calls follow the convention of AsmGenerator: arguments
+// on the stack in order, the result above them, the callee pops the arguments.
+class IrLowering {
+ public:
+  IrLowering(const std::string&);
+
+  void lower(const IrModule&);
+
+  AsmListing asm_file;
+
+ private:
+  void lowerFunction(const IrFunction&);
+  void lowerInstr(IrValue);
+  void lowerTerminator(IrBlockId);
+  void lowerCall(IrValue);
+  void lowerPrint(const IrInstr&);
+  void lowerOpenArrayCopy(const IrInstr&);
+  void lowerEpilogue();
+  // sets the flags for a Cmp or FCmp
+  void lowerCompare(const IrInstr&);
+  // moves the arguments of the phis of the block for the edge from -> to
+  void phiCopies(IrBlockId from, IrBlockId to);
+  bool hasPhi(IrBlockId) const;
+
+  // constants and addresses of storage, computed at each use
+  bool isRemat(IrValue) const;
+  // a constant an instruction takes as a sign extended imm32
+  bool isImm(IrValue) const;
+  bool inRegister(IrValue, Register) const;
+  void toGpr(Register, IrValue);
+  void toXmm(Register, IrValue);
+  void define(IrValue, Register);
+  // the register of the value, or the scratch register when it lives elsewhere
+  Register gprDest(IrValue) const;
+  Register xmmDest(IrValue) const;
+  // the value as an operand of an instruction: immediate, register or
+  // spill slot; anything else is built in the scratch register
+  Operand gprSource(IrValue, Register scratch);
+  Operand xmmSource(IrValue, Register scratch);
+  // memory addressed by the value, a computed address is loaded to the scratch register
+  Operand memOf(IrValue address, Register scratch);
+
+  Operand operandOf(const Location&) const;
+  void load(Register, const Location&);
+  void store(const Location&, Register);
+  void move(const Location& to, const Location& from);
+
+  const IrModule* module = nullptr;
+  const IrFunction* fn = nullptr;
+
+  std::vector<std::string> strings;
+  std::vector<std::string> labels;
+  // block laid out after the current one
+  IrBlockId next = 0;
+  std::vector<Location> locations;
+  std::vector<uint32_t> uses;
+  // a compare lowered together with the branch of its block
+  bool fused = false;
+
+  // rbp - offset
+  std::vector<uint64_t> slotOffset;
+  uint64_t spillOffset = 0;
+  std::vector<Register> saved;
+  std::vector<uint64_t> savedOffset;
+  // rbp + offset
+  std::vector<uint64_t> paramOffset;
+  uint64_t paramBytes = 0;
+
+  const std::string label_main = "main";
+  const std::string label_fmt_int = "fmt_int";
+  const std::string label_fmt_double = "fmt_double";
+  const std::string label_fmt_char = "fmt_char";
+  const std::string label_fmt_new_line = "fmt_new_line";
+};
@@ -0,0 +1,55 @@
+#include "listing.h"
+
+AsmListing::AsmListing(const std::string& s) : file(s) {}
+
+AsmListing::~AsmListing() {
+  flush();
+}
+
+AsmListing& AsmListing::operator <<(const Command& c) {
+  flushText();
+  commands.push_back(c);
+  return *this;
+}
+
+AsmListing& AsmListing::operator <<(const Comment& c) {
+  if (isComments) {
+    flushText();
+    commands.emplace_back(Command::Kind::Comment, strings.size(), c.str().size());
+    strings += c.str();
+  }
+  return *this;
+}
+
+void AsmListing::flush() {
+  flushText();
+  if (pass) {
+    pass(commands);
+  }
+  for (auto& c : commands) {
+    switch (c.getKind()) {
+      case Command::Kind::Text:
+        file.write(strings.data() + c.getOffset(), c.getSize());
+        break;
+      case Command::Kind::Comment:
+        file << "; ";
+        file.write(strings.data() + c.getOffset(), c.getSize());
+        file << "\n";
+        break;
+      default:
+        file << c;
+    }
+  }
+  file.flush();
+  commands.clear();
+  strings.clear();
+}
+
+void AsmListing::flushText() {
+  if (text.tellp() > 0) {
+    auto s = text.str();
+    commands.emplace_back(Command::Kind::Text, strings.size(), s.size());
+    strings += s;
+    text.str(std::string());
+  }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "opcode.h"
+
+// The assembler of a function kept as a list of commands until it is
+// complete, then rewritten by the pass and written in one go. Anything else
+// written between the commands (declarations of data) and the comments are
+// kept as text in one buffer the commands refer to.
+class AsmListing {
+ public:
+  using Pass = std::function<void(std::vector<Command>&)>;
+
+  AsmListing(const std::string&);
+  ~AsmListing();
+
+  AsmListing& operator <<(const Command&);
+  AsmListing& operator <<(const Comment&);
+  template <typename T>
+  AsmListing& operator <<(const T& t) {
+    text << t;
+    return *this;
+  }
+  // text written as is between the commands
+  std::ostream& raw() { return text; }
+  // comments written after this are dropped
+  void setComments(bool isComments) { this->isComments = isComments; }
+  // run over the commands of each flush before they are written
+  void setPass(Pass p) { pass = std::move(p); }
+
+  // writes what was listed since the last flush, at the end of a function; the destructor flushes the rest
+  void flush();
+
+ private:
+  void flushText();
+
+  std::ofstream file;
+  std::ostringstream text;
+  std::string strings;
+  std::vector<Command> commands;
+  bool isComments = true;
+  Pass pass;
+};
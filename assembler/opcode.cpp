@@ -1,16 +1,25 @@
 #include "opcode.h"
 
+#include <stdexcept>
 #include <string>
-#include <map>
-#include <iomanip>
+#include <unordered_map>
+#include <vector>
 
 std::string getLabel() {
   static int count = 0;
   return "label_" + std::to_string(count++);
 }
 
-std::string getLabelName(const std::string& s) {
-  return "___" + s;
+const std::string& getLabelName(Atom name) {
+  static std::vector<std::string> labels;
+  if (labels.size() <= name.getId()) {
+    labels.resize(name.getId() + 1);
+  }
+  auto& label = labels[name.getId()];
+  if (label.empty()) {
+    label = "___" + name.str();
+  }
+  return label;
 }
 
 std::string getStrName() {
@@ -18,200 +27,330 @@ std::string getStrName() {
   return "str_" + std::to_string(count++);
 }
 
-const std::map<Register, std::string> mapRegister = {
-  {AL,   "al"},
-  {AH,   "ah"},
-  {CL,   "cl"},
-  {RAX,  "rax"},
-  {RCX,  "rcx"},
-  {RDX,  "rdx"},
-  {RBX,  "rbx"},
-  {RSP,  "rsp"},
-  {RBP,  "rbp"},
-  {RSI,  "rsi"},
-  {RDI,  "rdi"},
-  {R8,   "r8"},
-  {R9,   "r9"},
-  {R10,  "r10"},
-  {R11,  "r11"},
-  {R12,  "r12"},
-  {R13,  "r13"},
-  {R14,  "r14"},
-  {R15,  "r15"},
-  {XMM0, "xmm0"},
-  {XMM1, "xmm1"},
+namespace {
+
+struct LabelTable {
+  std::unordered_map<std::string, uint32_t> ids;
+  std::vector<std::string> names;
 };
 
-std::ostream& operator <<(std::ostream &os, const Register& c) {
-  os << mapRegister.at(c);
-  return os;
+LabelTable& labelTable() {
+  static LabelTable table;
+  return table;
+}
+
+const std::string& labelName(uint32_t id) {
+  return labelTable().names[id];
 }
 
-const std::map<Pref, std::string> mapPref = {
-  {b,        "BYTE"},
-  {w,        "WORD"},
-  {d,        "DWORD"},
-  {q,        "QWORD"},
-  {none,     ""},
-  {double64, "__float64__"},
+const char* const registerName[] = {
+  "al",    // AL
+  "ah",    // AH
+  "cl",    // CL
+  "rax",   // RAX
+  "rcx",   // RCX
+  "rdx",   // RDX
+  "rbx",   // RBX
+  "rsp",   // RSP
+  "rbp",   // RBP
+  "rsi",   // RSI
+  "rdi",   // RDI
+  "r8",    // R8
+  "r9",    // R9
+  "r10",   // R10
+  "r11",   // R11
+  "r12",   // R12
+  "r13",   // R13
+  "r14",   // R14
+  "r15",   // R15
+  "xmm0",  // XMM0
+  "xmm1",  // XMM1
+  "xmm2",  // XMM2
+  "xmm3",  // XMM3
+  "xmm4",  // XMM4
+  "xmm5",  // XMM5
+  "xmm6",  // XMM6
+  "xmm7",  // XMM7
+  "xmm8",  // XMM8
+  "xmm9",  // XMM9
+  "xmm10", // XMM10
+  "xmm11", // XMM11
+  "xmm12", // XMM12
+  "xmm13", // XMM13
+  "xmm14", // XMM14
+  "xmm15", // XMM15
 };
 
-std::ostream& operator <<(std::ostream &os, const Pref& c) {
-  os << mapPref.at(c);
+const char* const prefName[] = {
+  "BYTE",
+  "WORD",
+  "DWORD",
+  "QWORD",
+  "",
+  "__float64__",
+};
+
+const char* const sysCallName[] = {
+  "printf",
+  "scanf",
+};
+
+const char* const instructionName[] = {
+  "db",       // DB
+  "dq",       // DQ
+  "resb",     // RESB
+  "resq",     // RESQ
+  "times",    // TIMES
+  "rep",      // REP
+  "movsb",    // MOVSB
+  "mov",      // MOV
+  "movq",     // MOVQ
+  "movzx",    // MOVZX
+  "lea",      // LEA
+  "push",     // PUSH
+  "pop",      // POP
+  "call",     // CALL
+  "ret",      // RET
+  "not",      // NOT
+  "xor",      // XOR
+  "and",      // AND
+  "or",       // OR
+  "add",      // ADD
+  "sub",      // SUB
+  "imul",     // IMUL
+  "idiv",     // IDIV
+  "cqo",      // CQO
+  "inc",      // INC
+  "dec",      // DEC
+  "neg",      // NEG
+  "shl",      // SHL
+  "shr",      // SHR
+  "sete",     // SETE
+  "setne",    // SETNE
+  "setl",     // SETL
+  "setg",     // SETG
+  "setge",    // SETGE
+  "setle",    // SETLE
+  "seta",     // SETA
+  "setb",     // SETB
+  "setae",    // SETAE
+  "setbe",    // SETBE
+  "cmp",      // CMP
+  "test",     // TEST
+  "cvtsi2sd", // CVTSI2SD
+  "cvtsd2si", // CVTSD2SI
+  "addsd",    // ADDSD
+  "subsd",    // SUBSD
+  "divsd",    // DIVSD
+  "mulsd",    // MULSD
+  "movsd",    // MOVSD
+  "comisd",   // COMISD
+  "xorpd",    // XORPD
+  "roundsd",  // ROUNDSD
+  "jz",       // JZ
+  "jnz",      // JNZ
+  "jmp",      // JMP
+  "je",       // JE
+  "jne",      // JNE
+  "jge",      // JGE
+  "jle",      // JLE
+  "jg",       // JG
+  "jl",       // JL
+  "ja",       // JA
+  "jae",      // JAE
+  "jb",       // JB
+  "jbe",      // JBE
+};
+
+const char* const sectionName[] = {
+  ".data",
+  ".bss",
+  ".text",
+};
+
+Register fullRegister(Register r) {
+  switch (r) {
+    case AL:
+    case AH: return RAX;
+    case CL: return RCX;
+    default: return r;
+  }
+}
+
+} // namespace
+
+std::ostream& operator <<(std::ostream &os, const Register& c) {
+  os << registerName[c];
   return os;
 }
 
-const std::map<SysCall, std::string> mapSysCall = {
-  {Printf,  "printf"},
-  {Scanf,   "scanf"}
-};
+std::ostream& operator <<(std::ostream &os, const Pref& c) {
+  os << prefName[c];
+  return os;
+}
 
 std::ostream& operator <<(std::ostream &os, const SysCall& c) {
-  os << mapSysCall.at(c);
+  os << sysCallName[c];
   return os;
 }
 
-const std::map<Instruction, std::string> mapInstruction = {
-  {DB,       "db"},
-  {DQ,       "dq"},
-  {RESB,     "resb"},
-  {RESQ,     "resq"},
-  {TIMES,    "times"},
-
-  {REP,      "rep"},
-  {MOVSB,    "movsb"},
-  {MOV,      "mov"},
-  {MOVQ,     "movq"},
-  {NOT,      "not"},
-  {XOR,      "xor"},
-  {AND,      "and"},
-  {OR,       "or"},
-  {PUSH,     "push"},
-  {POP,      "pop"},
-  {CALL,     "call"},
-  {LEA,      "lea"},
-  {RET,      "ret"},
-  {ADD,      "add"},
-  {SUB,      "sub"},
-  {IMUL,     "imul"},
-  {IDIV,     "idiv"},
-  {CQO,      "cqo"},
-  {SETE,     "sete"},
-  {SETNE,    "setne"},
-  {SETL,     "setl"},
-  {SETG,     "setg"},
-  {SETGE,    "setge"},
-  {SETLE,    "setle"},
-  {SETA,     "seta"},
-  {SETB,     "setb"},
-  {SETAE,    "setae"},
-  {SETBE,    "setbe"},
-  {CMP,      "cmp"},
-  {CVTSI2SD, "cvtsi2sd"},
-  {CVTSD2SI, "cvtsd2si"},
-  {ADDSD,    "addsd"},
-  {SUBSD,    "subsd"},
-  {DIVSD,    "divsd"},
-  {MULSD,    "mulsd"},
-  {MOVSD,    "movsd"},
-  {COMISD,   "comisd"},
-  {XORPD,    "xorpd"},
-  {NEG,      "neg"},
-  {SHL,      "shl"},
-  {SHR,      "shr"},
-  {JZ,       "jz"},
-  {JNZ,      "jnz"},
-  {JMP,      "jmp"},
-  {JE,       "je"},
-  {JGE,      "jge"},
-  {JLE,      "jle"},
-  {JG,       "jg"},
-  {JL,       "jl"},
-  {TEST,     "test"},
-  {INC,      "inc"},
-  {DEC,      "dec"},
-  {ROUNDSD,  "roundsd"},
-};
-
 std::ostream& operator <<(std::ostream &os, const Instruction& c) {
-  os << mapInstruction.at(c);
+  os << instructionName[c];
   return os;
 }
 
-const std::map<Section, std::string> mapSection = {
-  {data, ".data"},
-  {bss,  ".bss"},
-  {code, ".text"},
-};
-
 std::ostream& operator <<(std::ostream& os, const Section& s) {
-  os << mapSection.at(s);
+  os << sectionName[s];
   return os;
 }
 
-Label::Label(std::string s) : s(s) {}
+Label::Label(const std::string& s) {
+  auto& table = labelTable();
+  auto it = table.ids.emplace(s, table.names.size());
+  if (it.second) {
+    table.names.push_back(s);
+  }
+  id = it.first->second;
+}
+
+const std::string& Label::str() const {
+  return labelName(id);
+}
+
 std::ostream& operator <<(std::ostream &os, const Label& c) {
-  os << c.s;
+  os << c.str();
   return os;
 }
 
-EffectiveAddress::EffectiveAddress(Register b) : isOnlyBase(true) { base << b; }
-EffectiveAddress::EffectiveAddress(Label l) : isOnlyBase(true) { base << l; }
-EffectiveAddress::EffectiveAddress(Register b, Register i, uint64_t s)
-  : index(i), scala(s) { base << b; }
-EffectiveAddress::EffectiveAddress(Register b, uint64_t offset, bool isMinus)
-  : isOnlyBase(true), isOffset(true), offset(offset), isMinus(isMinus) {
-  base << b;
+EffectiveAddress::EffectiveAddress()
+  : base(RAX), index(RAX), scale(1), hasBase(false), hasIndex(false), hasOffset(false), isMinus(false),
+    label(0), offset(0) {}
+EffectiveAddress::EffectiveAddress(Register b) : EffectiveAddress() {
+  base = b;
+  hasBase = true;
+}
+EffectiveAddress::EffectiveAddress(Label l) : EffectiveAddress() { label = l.getId(); }
+EffectiveAddress::EffectiveAddress(Register b, Register i, uint64_t s) : EffectiveAddress() {
+  base = b;
+  index = i;
+  scale = s;
+  hasBase = true;
+  hasIndex = true;
+}
+EffectiveAddress::EffectiveAddress(Register b, uint64_t offset, bool isMinus) : EffectiveAddress() {
+  base = b;
+  hasBase = true;
+  hasOffset = true;
+  this->offset = offset;
+  this->isMinus = isMinus;
 }
 
 std::ostream& operator <<(std::ostream &os, const EffectiveAddress& c) {
-  os << "[" << c.base.str();
+  os << "[";
+  if (c.hasBase) {
+    os << c.base;
+  } else {
+    os << labelName(c.label);
+  }
   char opr = c.isMinus ? '-' : '+';
-  if (!c.isOnlyBase) {
-    os << opr << c.index << "*" << c.scala;
+  if (c.hasIndex) {
+    os << opr << c.index << "*" << static_cast<unsigned>(c.scale);
   }
-  if (c.isOffset) {
+  if (c.hasOffset) {
     os << opr << c.offset;
   }
   os << "]";
   return os;
 }
 
-Operand::Operand(uint64_t u, Pref p) { s << p << " " << u; }
-Operand::Operand(std::string u, Pref p) { s << p << " \"" << u << "\""; }
-Operand::Operand(long double u, Pref p) {
-  s << std::showpoint;
-  if (p == Pref::double64)
-    s << p << "("  << std::to_string(u) << ")";
-  else
-    s << p << " " << std::to_string(u);
+Operand::Operand(uint64_t u, Pref p) : kind(Kind::Imm), pref(p), imm(u) {}
+Operand::Operand(long double u, Pref p) : kind(Kind::Real), pref(p), real(u) {}
+Operand::Operand(const std::string& u, Pref p) : kind(Kind::Chars), pref(p), size(u.size()), imm(0) {
+  if (u.size() > sizeof(imm)) {
+    throw std::logic_error("Immediate of more than 8 characters: " + u);
+  }
+  for (std::size_t k = 0; k < u.size(); ++k) {
+    imm |= uint64_t(static_cast<uint8_t>(u[k])) << (8 * k);
+  }
 }
-Operand::Operand(Label l) { s << l; }
-Operand::Operand(EffectiveAddress e, Pref p) { s << p << " " << e; }
-Operand::Operand(Register r, Pref p) { s << p << " " << r; }
-Operand::Operand(SysCall c) { s << c; }
+Operand::Operand(Label l) : kind(Kind::Label), imm(l.getId()) {}
+Operand::Operand(EffectiveAddress e, Pref p) : kind(Kind::Mem), pref(p), address(e), imm(0) {}
+Operand::Operand(Register r, Pref p) : kind(Kind::Reg), pref(p), reg(r), imm(0) {}
+Operand::Operand(SysCall c) : kind(Kind::SysCall), imm(c) {}
 
-std::ostream& operator <<(std::ostream &os, const Operand& o) {
-  os << o.s.str();
-  return os;
+bool Operand::operator ==(const Operand& o) const {
+  if (kind != o.kind || pref != o.pref) {
+    return false;
+  }
+  auto& a = address;
+  auto& b = o.address;
+  switch (kind) {
+    case Kind::Empty: return true;
+    case Kind::Real: return real == o.real;
+    case Kind::Chars: return size == o.size && imm == o.imm;
+    case Kind::Reg: return reg == o.reg;
+    case Kind::Mem:
+      return a.hasBase == b.hasBase && a.hasIndex == b.hasIndex && a.hasOffset == b.hasOffset
+        && (a.hasBase ? a.base == b.base : a.label == b.label)
+        && (!a.hasIndex || (a.index == b.index && a.scale == b.scale))
+        && (!a.hasOffset || (a.offset == b.offset && a.isMinus == b.isMinus));
+    default: return imm == o.imm;
+  }
 }
 
-Command::Command(SysCall c) { s << "extern " << c << "\n"; }
-Command::Command(Section o) { s << "\nsection " << o << "\n"; }
-Command::Command(Label l) { s << l << ":\n"; }
-Command::Command(Label l, bool isGlobal) { s << "global " << l << "\n"; }
-Command::Command(Instruction i) { s << "\t" << i << "\n";}
-Command::Command(Instruction i, Operand o) { s << "\t" << i << " " << o << "\n"; }
-Command::Command(Instruction i, Operand o1, Operand o2) { 
-  s << "\t" << i << " " << o1 << ", " << o2 << "\n"; 
+bool Operand::uses(Register r) const {
+  switch (kind) {
+    case Kind::Reg: return fullRegister(reg) == fullRegister(r);
+    case Kind::Mem:
+      return (address.hasBase && address.base == fullRegister(r))
+        || (address.hasIndex && address.index == fullRegister(r));
+    default: return false;
+  }
 }
-Command::Command(Instruction i, Operand o1, Operand o2, Operand o3) { 
-  s << "\t" << i << " " << o1 << ", " << o2 << ", " << o3<< "\n"; 
+
+bool Operand::isAddressOf(Register r) const {
+  return kind == Kind::Mem && address.hasBase && address.base == r && !address.hasIndex && !address.hasOffset;
 }
-Command::Command(Instruction i, Instruction i1) { s << "\t" << i << " " << i1 << "\n"; }
 
-std::ostream& operator <<(std::ostream& os, const Command& c) {
-  os << c.s.str();
+Operand Operand::withPref(Pref p) const {
+  Operand o = *this;
+  o.pref = p;
+  return o;
+}
+
+std::ostream& operator <<(std::ostream &os, const Operand& o) {
+  switch (o.kind) {
+    case Operand::Kind::Empty:
+      break;
+    case Operand::Kind::Imm:
+      os << o.pref << " " << o.imm;
+      break;
+    case Operand::Kind::Real:
+      if (o.pref == Pref::double64)
+        os << o.pref << "("  << std::to_string(o.real) << ")";
+      else
+        os << o.pref << " " << std::to_string(o.real);
+      break;
+    case Operand::Kind::Chars:
+      os << o.pref << " \"";
+      for (std::size_t k = 0; k < o.size; ++k) {
+        os << static_cast<char>(o.imm >> (8 * k));
+      }
+      os << "\"";
+      break;
+    case Operand::Kind::Reg:
+      os << o.pref << " " << o.reg;
+      break;
+    case Operand::Kind::Mem:
+      os << o.pref << " " << o.address;
+      break;
+    case Operand::Kind::Label:
+      os << labelName(o.getLabelId());
+      break;
+    case Operand::Kind::SysCall:
+      os << static_cast<SysCall>(o.imm);
+      break;
+  }
   return os;
 }
 
@@ -219,4 +358,47 @@ Comment::Comment(std::string ss) : s(std::move(ss)) {}
 std::ostream& operator <<(std::ostream& os, const Comment& c) {
   os << "; " << c.s << "\n";
   return os;
-}
\ No newline at end of file
+}
+
+Command::Command(SysCall c) : kind(Kind::Extern), value(c) {}
+Command::Command(Section o) : kind(Kind::Section), value(o) {}
+Command::Command(Label l) : kind(Kind::Label), value(l.getId()) {}
+Command::Command(Label l, bool isGlobal) : kind(Kind::Global), value(l.getId()) {}
+Command::Command(Instruction i) : instruction(i) {}
+Command::Command(Instruction i, Operand o) : instruction(i), numOperands(1), operands{o} {}
+Command::Command(Instruction i, Operand o1, Operand o2) : instruction(i), numOperands(2), operands{o1, o2} {}
+Command::Command(Instruction i, Operand o1, Operand o2, Operand o3)
+  : instruction(i), numOperands(3), operands{o1, o2, o3} {}
+Command::Command(Instruction i, Instruction i1) : instruction(i), repeated(i1) {}
+Command::Command(Kind k, uint32_t offset, uint32_t size) : kind(k), value(offset), size(size) {}
+
+std::ostream& operator <<(std::ostream& os, const Command& c) {
+  switch (c.kind) {
+    case Command::Kind::Text:
+    case Command::Kind::Comment:
+      break;
+    case Command::Kind::Extern:
+      os << "extern " << static_cast<SysCall>(c.value) << "\n";
+      break;
+    case Command::Kind::Section:
+      os << "\nsection " << static_cast<Section>(c.value) << "\n";
+      break;
+    case Command::Kind::Global:
+      os << "global " << labelName(c.value) << "\n";
+      break;
+    case Command::Kind::Label:
+      os << labelName(c.value) << ":\n";
+      break;
+    case Command::Kind::Instr:
+      os << "\t" << c.instruction;
+      if (c.instruction == REP) {
+        os << " " << c.repeated;
+      }
+      for (std::size_t k = 0; k < c.numOperands; ++k) {
+        os << (k == 0 ? " " : ", ") << c.operands[k];
+      }
+      os << "\n";
+      break;
+  }
+  return os;
+}
@@ -2,23 +2,26 @@
 
 #include <stdint-gcc.h>
 #include <ostream>
-#include <sstream>
+#include <string>
+
+#include "atom.h"
 
 
 std::string getLabel();
 std::string getStrName();
-std::string getLabelName(const std::string&);
+const std::string& getLabelName(Atom);
 
-enum Register {
+enum Register : uint8_t {
   AL, AH, CL,
   RAX, RCX, RDX, RBX,
   RSP, RBP,
   RSI, RDI,
   R8, R9, R10, R11, R12, R13, R14, R15,
-  XMM0, XMM1
+  XMM0, XMM1, XMM2, XMM3, XMM4, XMM5, XMM6, XMM7,
+  XMM8, XMM9, XMM10, XMM11, XMM12, XMM13, XMM14, XMM15
 };
 
-enum Pref {
+enum Pref : uint8_t {
   b,// (от byte) — операнды размером в 1 байт
   w,//(от word)— операнды размером в 1 слово (2 байта)
   d,//(от long) — операнды размером в 4 байта
@@ -27,12 +30,12 @@ enum Pref {
   double64,
 };
 
-enum SysCall {
+enum SysCall : uint8_t {
   Printf,
   Scanf,
 };
 
-enum Instruction {
+enum Instruction : uint8_t {
   DB,
   DQ,
   RESB,
@@ -43,6 +46,7 @@ enum Instruction {
   MOVSB,
   MOV,
   MOVQ,
+  MOVZX,
   LEA,
 
   PUSH,
@@ -95,13 +99,18 @@ enum Instruction {
   JNZ,
   JMP,
   JE,
+  JNE,
   JGE,
   JLE,
   JG,
   JL,
+  JA,
+  JAE,
+  JB,
+  JBE,
 };
 
-enum Section {
+enum Section : uint8_t {
   data,
   bss,
   code,
@@ -113,13 +122,17 @@ std::ostream& operator <<(std::ostream &os, const SysCall&);
 std::ostream& operator <<(std::ostream &os, const Instruction&);
 std::ostream& operator <<(std::ostream &os, const Section&);
 
+// An id into the names of the labels of the program, equal names get equal ids.
 class Label {
  public:
-  Label(std::string);
+  Label(const std::string&);
   friend std::ostream& operator <<(std::ostream &os, const Label&);
 
+  uint32_t getId() const { return id; }
+  const std::string& str() const;
+
  private:
-  std::string s;
+  uint32_t id;
 };
 
 class EffectiveAddress {
@@ -131,41 +144,102 @@ class EffectiveAddress {
   friend std::ostream& operator <<(std::ostream &os, const EffectiveAddress&);
 
  private:
-  bool isOnlyBase = false;
-  bool isOffset = false;
+  friend class Operand;
+  EffectiveAddress();
 
-  std::stringstream base;
+  Register base;
   Register index;
-  uint64_t scala;
+  uint8_t scale;
+  bool hasBase : 1;
+  bool hasIndex : 1;
+  bool hasOffset : 1;
+  bool isMinus : 1;
+  // the label when there is no base
+  uint32_t label;
   int offset;
-  bool isMinus = false;
 };
 
+// One operand of an instruction, copied as plain bytes and written out only
+// with the listing.
 class Operand {
  public:
-  Operand() = default;
+  enum class Kind : uint8_t {
+    Empty,
+    Imm,
+    Real,
+    // up to 8 characters taken as an immediate
+    Chars,
+    Reg,
+    Mem,
+    Label,
+    SysCall,
+  };
+
+  Operand() : imm(0) {}
   Operand(uint64_t, Pref = q);
   Operand(long double, Pref = q);
-  Operand(std::string, Pref = q);
+  Operand(const std::string&, Pref = q);
   Operand(Label);
   Operand(EffectiveAddress, Pref = q);
   Operand(Register, Pref = q);
   Operand(SysCall);
   friend std::ostream& operator <<(std::ostream &os, const Operand&);
 
-  Operand(const Operand& o) { s.str(std::string()); s << o.s.str(); }
-  Operand& operator=(const Operand& o) {
-    s.str(std::string());
-    s << o.s.str();
-    return *this;
-  }
+  bool operator ==(const Operand&) const;
+  bool operator !=(const Operand& o) const { return !(*this == o); }
+
+  Kind getKind() const { return kind; }
+  Pref getPref() const { return pref; }
+  Register getRegister() const { return reg; }
+  uint64_t getImm() const { return imm; }
+  // Label: the id of the label
+  uint32_t getLabelId() const { return static_cast<uint32_t>(imm); }
+  // reads the register or computes the address with it; al, ah and cl are parts of rax and rcx
+  bool uses(Register) const;
+  // memory addressed by the register alone
+  bool isAddressOf(Register) const;
+  // the same memory with another size prefix
+  Operand withPref(Pref) const;
 
  private:
-  std::stringstream s;
+  Kind kind = Kind::Empty;
+  Pref pref = none;
+  Register reg = RAX;
+  // Chars: the number of characters
+  uint8_t size = 0;
+  EffectiveAddress address;
+  // Imm, Chars, Label and SysCall keep their value in imm
+  union {
+    uint64_t imm;
+    long double real;
+  };
 };
 
+class Comment {
+ public:
+  Comment(std::string ss);
+  friend std::ostream& operator <<(std::ostream& os, const Comment&);
+
+  const std::string& str() const { return s; }
+
+ private:
+  std::string s;
+};
+
+// A line of the listing. Text and comments are kept by AsmListing, the
+// command only refers to their place there and writes nothing itself.
 class Command {
  public:
+  enum class Kind : uint8_t {
+    Text,
+    Comment,
+    Extern,
+    Section,
+    Global,
+    Label,
+    Instr,
+  };
+
   Command(SysCall);
   Command(Section);
   Command(Label);
@@ -175,19 +249,32 @@ class Command {
   Command(Instruction, Operand);
   Command(Instruction, Operand, Operand);
   Command(Instruction, Operand, Operand, Operand);
+  // Text or Comment of the given size at the offset
+  Command(Kind, uint32_t offset, uint32_t size);
   friend std::ostream& operator <<(std::ostream& os, const Command&);
 
- private:
-  std::stringstream s;
-};
-
-class Comment {
- public:
-  Comment(std::string ss);
-  friend std::ostream& operator <<(std::ostream& os, const Comment&);
+  Kind getKind() const { return kind; }
+  // Instr: rep movsb is REP without operands
+  Instruction getInstruction() const { return instruction; }
+  std::size_t getNumOperands() const { return numOperands; }
+  const Operand& getOperand(std::size_t k) const { return operands[k]; }
+  // Label and Global: the id of the label
+  uint32_t getLabelId() const { return value; }
+  // Text and Comment
+  uint32_t getOffset() const { return value; }
+  uint32_t getSize() const { return size; }
 
  private:
-  std::string s;
+  Kind kind = Kind::Instr;
+  Instruction instruction = DB;
+  // REP: the instruction it repeats
+  Instruction repeated = DB;
+  uint8_t numOperands = 0;
+  // the label, the section or the system call, or the offset of the text
+  uint32_t value = 0;
+  uint32_t size = 0;
+  Operand operands[3];
 };
+
 using cmd = Command;
-using adr = EffectiveAddress;
\ No newline at end of file
+using adr = EffectiveAddress;
@@ -0,0 +1,246 @@
+#include "peephole.h"
+
+#include <cstdint>
+
+namespace {
+
+const std::size_t npos = SIZE_MAX;
+
+bool isInstr(const Command& c, Instruction i) {
+  return c.getKind() == Command::Kind::Instr && c.getInstruction() == i;
+}
+
+bool isReg(const Operand& o, Register r) {
+  return o.getKind() == Operand::Kind::Reg && o.getRegister() == r;
+}
+
+bool isGpr(const Operand& o) {
+  return o.getKind() == Operand::Kind::Reg && o.getRegister() >= RAX && o.getRegister() <= R15;
+}
+
+bool isImm32(const Operand& o) {
+  auto v = static_cast<int64_t>(o.getImm());
+  return v >= INT32_MIN && v <= INT32_MAX;
+}
+
+// reads or writes registers its operands do not show, or leaves the straight line code
+bool isOpaque(Instruction i) {
+  switch (i) {
+    case CALL:
+    case RET:
+    case IDIV:
+    case CQO:
+    case REP:
+    case MOVSB:
+      return true;
+    default:
+      return i >= JZ && i <= JBE;
+  }
+}
+
+// writes the first operand without reading it
+bool isOverwrite(Instruction i) {
+  switch (i) {
+    case MOV:
+    case MOVQ:
+    case MOVZX:
+    case LEA:
+    case CVTSD2SI:
+    case POP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+Peephole::Peephole() {
+  patterns = {
+    {"push r; pop r", &Peephole::pushPopSame, 0},
+    {"push a; pop b", &Peephole::pushPopMove, 0},
+    {"lea r, m; push [r]", &Peephole::foldAddress, 0},
+    {"xor rdx, rdx; cqo", &Peephole::clearBeforeCqo, 0},
+    {"jmp to next label", &Peephole::jumpToNext, 0},
+    {"add/sub rsp, 0", &Peephole::moveStackByZero, 0},
+  };
+}
+
+void Peephole::run(std::vector<Command>& c) {
+  commands = &c;
+  removed.assign(c.size(), false);
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (std::size_t k = 0; k < c.size(); ++k) {
+      if (removed[k] || c[k].getKind() != Command::Kind::Instr) {
+        continue;
+      }
+      for (auto& p : patterns) {
+        auto n = (this->*p.rule)(k);
+        if (n > 0) {
+          p.removed += n;
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
+
+  std::size_t size = 0;
+  for (std::size_t k = 0; k < c.size(); ++k) {
+    if (!removed[k]) {
+      c[size++] = c[k];
+    }
+  }
+  c.erase(c.begin() + size, c.end());
+  commands = nullptr;
+}
+
+void Peephole::report(std::ostream& os) const {
+  std::size_t total = 0;
+  for (auto& p : patterns) {
+    os << "peephole " << p.name << ": " << p.removed << std::endl;
+    total += p.removed;
+  }
+  os << "peephole removed: " << total << std::endl;
+}
+
+std::size_t Peephole::next(std::size_t k) const {
+  auto& c = *commands;
+  for (++k; k < c.size(); ++k) {
+    if (removed[k] || c[k].getKind() == Command::Kind::Comment) {
+      continue;
+    }
+    return c[k].getKind() == Command::Kind::Instr ? k : npos;
+  }
+  return npos;
+}
+
+bool Peephole::isDead(Register r, std::size_t k) const {
+  for (k = next(k); k != npos; k = next(k)) {
+    auto& c = (*commands)[k];
+    if (isOpaque(c.getInstruction())) {
+      return false;
+    }
+    auto size = c.getNumOperands();
+    if (size == 2 && c.getInstruction() == XOR && isReg(c.getOperand(0), r) && isReg(c.getOperand(1), r)) {
+      return true;
+    }
+    bool isWrite = size > 0 && isOverwrite(c.getInstruction()) && isReg(c.getOperand(0), r);
+    for (std::size_t m = 0; m < size; ++m) {
+      if (c.getOperand(m).uses(r) && !(m == 0 && isWrite)) {
+        return false;
+      }
+    }
+    if (isWrite) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::size_t Peephole::pushPopSame(std::size_t k) {
+  auto& c = *commands;
+  auto j = next(k);
+  if (!isInstr(c[k], PUSH) || j == npos || !isInstr(c[j], POP)) {
+    return 0;
+  }
+  auto& a = c[k].getOperand(0);
+  auto& b = c[j].getOperand(0);
+  if (a.getKind() != Operand::Kind::Reg || a != b) {
+    return 0;
+  }
+  removed[k] = removed[j] = true;
+  return 2;
+}
+
+std::size_t Peephole::pushPopMove(std::size_t k) {
+  auto& c = *commands;
+  auto j = next(k);
+  if (!isInstr(c[k], PUSH) || j == npos || !isInstr(c[j], POP)) {
+    return 0;
+  }
+  auto a = c[k].getOperand(0);
+  auto b = c[j].getOperand(0);
+  auto isMem = [](const Operand& o) { return o.getKind() == Operand::Kind::Mem; };
+  bool isSource = isGpr(a) || isMem(a) || a.getKind() == Operand::Kind::Imm;
+  bool isDest = isGpr(b) || (isMem(b) && !isMem(a));
+  // push and pop move rsp between reading and writing
+  if (!isSource || !isDest || a.uses(RSP) || b.uses(RSP)
+      || (isMem(b) && a.getKind() == Operand::Kind::Imm && !isImm32(a))) {
+    return 0;
+  }
+  c[k] = Command(MOV, b, a);
+  removed[j] = true;
+  return 1;
+}
+
+std::size_t Peephole::foldAddress(std::size_t k) {
+  auto& c = *commands;
+  auto j = next(k);
+  if (!isInstr(c[k], LEA) || j == npos || !isInstr(c[j], PUSH)) {
+    return 0;
+  }
+  auto r = c[k].getOperand(0);
+  auto m = c[k].getOperand(1);
+  auto o = c[j].getOperand(0);
+  if (!isGpr(r) || !o.isAddressOf(r.getRegister()) || m.uses(RSP) || !isDead(r.getRegister(), j)) {
+    return 0;
+  }
+  c[j] = Command(PUSH, m.withPref(o.getPref()));
+  removed[k] = true;
+  return 1;
+}
+
+std::size_t Peephole::clearBeforeCqo(std::size_t k) {
+  auto& c = *commands;
+  if (!isInstr(c[k], XOR) || !isReg(c[k].getOperand(0), RDX) || !isReg(c[k].getOperand(1), RDX)) {
+    return 0;
+  }
+  // cqo writes rdx and idiv leaves the flags undefined
+  auto j = next(k);
+  auto l = j == npos ? npos : next(j);
+  if (j == npos || !isInstr(c[j], CQO) || l == npos || !isInstr(c[l], IDIV)) {
+    return 0;
+  }
+  removed[k] = true;
+  return 1;
+}
+
+std::size_t Peephole::jumpToNext(std::size_t k) {
+  auto& c = *commands;
+  if (!isInstr(c[k], JMP)) {
+    return 0;
+  }
+  auto& target = c[k].getOperand(0);
+  if (target.getKind() != Operand::Kind::Label) {
+    return 0;
+  }
+  for (auto j = k + 1; j < c.size(); ++j) {
+    auto kind = c[j].getKind();
+    if (removed[j] || kind == Command::Kind::Comment) {
+      continue;
+    }
+    if (kind != Command::Kind::Label) {
+      return 0;
+    }
+    if (c[j].getLabelId() == target.getLabelId()) {
+      removed[k] = true;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+std::size_t Peephole::moveStackByZero(std::size_t k) {
+  auto& c = *commands;
+  if (!isInstr(c[k], ADD) && !isInstr(c[k], SUB)) {
+    return 0;
+  }
+  auto& size = c[k].getOperand(1);
+  if (!isReg(c[k].getOperand(0), RSP) || size.getKind() != Operand::Kind::Imm || size.getImm() != 0) {
+    return 0;
+  }
+  removed[k] = true;
+  return 1;
+}
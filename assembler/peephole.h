@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+#include "opcode.h"
+
+// Rewrites short sequences of instructions the generators leave behind, most
+// of them from the stack machine of AsmGenerator. A pattern matches at an
+// instruction and the ones after it in the same straight line code: comments
+// are looked through, labels and text are not. The patterns are tried in the
+// order of the table until none of them matches.
+class Peephole {
+ public:
+  Peephole();
+
+  void run(std::vector<Command>&);
+  // instructions each pattern removed over all runs
+  void report(std::ostream&) const;
+
+ private:
+  // the number of instructions removed, 0 when the pattern does not match at k
+  using Rule = std::size_t (Peephole::*)(std::size_t k);
+  struct Pattern {
+    const char* name;
+    Rule rule;
+    std::size_t removed;
+  };
+
+  // push r; pop r
+  std::size_t pushPopSame(std::size_t);
+  // push a; pop b -> mov b, a
+  std::size_t pushPopMove(std::size_t);
+  // lea r, m; push [r] -> push m, when r is not read after
+  std::size_t foldAddress(std::size_t);
+  // xor rdx, rdx; cqo; idiv -> cqo; idiv
+  std::size_t clearBeforeCqo(std::size_t);
+  // jmp l; l:
+  std::size_t jumpToNext(std::size_t);
+  // add rsp, 0 and sub rsp, 0
+  std::size_t moveStackByZero(std::size_t);
+
+  // the instruction after k in the same straight line code, npos at a label, text or the end
+  std::size_t next(std::size_t) const;
+  // the register is written before it is read after k, within the straight line code
+  bool isDead(Register, std::size_t) const;
+
+  std::vector<Pattern> patterns;
+  std::vector<Command>* commands = nullptr;
+  std::vector<bool> removed;
+};
@@ -0,0 +1,224 @@
+#include "register_allocator.h"
+
+#include <algorithm>
+
+namespace {
+
+const std::vector<Register> anyGpr = {R8, R9, R10, RBX, R12, R13, R14, R15};
+const std::vector<Register> calleeSavedGpr = {RBX, R12, R13, R14, R15};
+const std::vector<Register> anyXmm = {
+  XMM2, XMM3, XMM4, XMM5, XMM6, XMM7, XMM8,
+  XMM9, XMM10, XMM11, XMM12, XMM13, XMM14, XMM15,
+};
+const std::vector<Register> noRegisters;
+
+const uint32_t noIndex = UINT32_MAX;
+
+using Bits = std::vector<uint64_t>;
+
+void setBit(Bits& bits, uint32_t k) {
+  bits[k / 64] |= uint64_t(1) << (k % 64);
+}
+
+bool testBit(const Bits& bits, uint32_t k) {
+  return (bits[k / 64] >> (k % 64)) & 1;
+}
+
+template <typename F>
+void forEachBit(const Bits& bits, F f) {
+  for (std::size_t w = 0; w < bits.size(); ++w) {
+    for (uint64_t word = bits[w]; word != 0; word &= word - 1) {
+      f(static_cast<uint32_t>(w * 64 + __builtin_ctzll(word)));
+    }
+  }
+}
+
+// registers printf and the callees do not preserve
+bool clobbers(const IrInstr& i) {
+  return i.op == IrOp::Call || i.op == IrOp::Print;
+}
+
+} // namespace
+
+bool isRematerialized(const IrInstr& i) {
+  switch (i.op) {
+    case IrOp::Const:
+    case IrOp::ConstDouble:
+    case IrOp::Global:
+    case IrOp::String:
+    case IrOp::FunctionAddr:
+    case IrOp::Local:
+    case IrOp::Param:
+    case IrOp::Result:
+      return true;
+    default:
+      return false;
+  }
+}
+
+RegisterAllocator::RegisterAllocator(const IrFunction& f) : fn(f), locations(f.instrs.size()) {
+  buildIntervals();
+  scan();
+}
+
+void RegisterAllocator::buildIntervals() {
+  auto blocks = fn.blocks.size();
+  std::vector<uint32_t> index(fn.instrs.size(), noIndex);
+  std::vector<IrValue> values;
+  std::vector<uint32_t> position(fn.instrs.size(), 0);
+  std::vector<uint32_t> blockStart(blocks), blockEnd(blocks);
+  std::vector<uint32_t> calls;
+  uint32_t pos = 0;
+  for (IrBlockId b = 0; b < blocks; ++b) {
+    blockStart[b] = pos;
+    for (auto v : fn.blocks[b].instrs) {
+      auto& i = fn.get(v);
+      position[v] = pos;
+      if (clobbers(i)) {
+        calls.push_back(pos);
+      }
+      if (i.type != IrType::Void && !isRematerialized(i)) {
+        index[v] = values.size();
+        values.push_back(v);
+      }
+      pos += 2;
+    }
+    blockEnd[b] = pos - 1;
+  }
+
+  // live variables, the arguments of a phi are live out of their predecessors
+  std::size_t words = (values.size() + 63) / 64;
+  std::vector<Bits> gen(blocks, Bits(words)), kill(blocks, Bits(words));
+  std::vector<Bits> phiOut(blocks, Bits(words));
+  for (IrBlockId b = 0; b < blocks; ++b) {
+    for (auto v : fn.blocks[b].instrs) {
+      auto& i = fn.get(v);
+      for (std::size_t k = 0; k < i.args.size(); ++k) {
+        auto a = index[i.args[k]];
+        if (a == noIndex) {
+          continue;
+        }
+        if (i.op == IrOp::Phi) {
+          setBit(phiOut[i.from[k]], a);
+        } else if (!testBit(kill[b], a)) {
+          setBit(gen[b], a);
+        }
+      }
+      if (index[v] != noIndex) {
+        setBit(kill[b], index[v]);
+      }
+    }
+  }
+  std::vector<Bits> liveIn(blocks, Bits(words)), liveOut(blocks, Bits(words));
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (IrBlockId b = blocks; b-- > 0;) {
+      auto& out = liveOut[b];
+      auto& in = liveIn[b];
+      for (std::size_t w = 0; w < words; ++w) {
+        uint64_t o = phiOut[b][w];
+        for (auto s : fn.blocks[b].succs) {
+          o |= liveIn[s][w];
+        }
+        uint64_t n = gen[b][w] | (o & ~kill[b][w]);
+        if (o != out[w] || n != in[w]) {
+          out[w] = o;
+          in[w] = n;
+          changed = true;
+        }
+      }
+    }
+  }
+
+  std::vector<uint32_t> start(values.size()), end(values.size());
+  for (std::size_t k = 0; k < values.size(); ++k) {
+    start[k] = end[k] = position[values[k]] + 1;
+  }
+  for (IrBlockId b = 0; b < blocks; ++b) {
+    for (auto v : fn.blocks[b].instrs) {
+      auto& i = fn.get(v);
+      if (i.op == IrOp::Phi) {
+        continue;
+      }
+      for (auto a : i.args) {
+        if (index[a] != noIndex) {
+          end[index[a]] = std::max(end[index[a]], position[v]);
+        }
+      }
+    }
+    forEachBit(liveIn[b], [&](uint32_t k) { start[k] = std::min(start[k], blockStart[b]); });
+    forEachBit(liveOut[b], [&](uint32_t k) { end[k] = std::max(end[k], blockEnd[b]); });
+  }
+
+  intervals.clear();
+  for (std::size_t k = 0; k < values.size(); ++k) {
+    auto call = std::lower_bound(calls.begin(), calls.end(), start[k]);
+    intervals.push_back({values[k], start[k], end[k], call != calls.end() && *call < end[k]});
+  }
+  std::sort(intervals.begin(), intervals.end(), [](const Interval& a, const Interval& b) {
+    return a.start < b.start;
+  });
+}
+
+void RegisterAllocator::scan() {
+  struct Active {
+    uint32_t end;
+    IrValue value;
+    Register reg;
+  };
+  std::vector<Active> active;
+
+  for (auto& it : intervals) {
+    active.erase(std::remove_if(active.begin(), active.end(), [&](const Active& a) {
+      return a.end < it.start;
+    }), active.end());
+
+    bool isDouble = fn.get(it.value).type == IrType::Double;
+    auto& pool = isDouble
+      ? (it.crossesCall ? noRegisters : anyXmm)
+      : (it.crossesCall ? calleeSavedGpr : anyGpr);
+    auto kind = isDouble ? Location::Xmm : Location::Gpr;
+
+    auto free = std::find_if(pool.begin(), pool.end(), [&](Register r) {
+      return std::none_of(active.begin(), active.end(), [&](const Active& a) {
+        return a.reg == r && locations[a.value].kind == kind;
+      });
+    });
+    if (free != pool.end()) {
+      locations[it.value] = {kind, *free, 0};
+      active.push_back({it.end, it.value, *free});
+      continue;
+    }
+
+    // the interval that ends last gives its register up
+    Active* victim = nullptr;
+    for (auto& a : active) {
+      if (locations[a.value].kind == kind
+          && std::find(pool.begin(), pool.end(), a.reg) != pool.end()
+          && (victim == nullptr || a.end > victim->end)) {
+        victim = &a;
+      }
+    }
+    if (victim != nullptr && victim->end > it.end) {
+      locations[it.value] = {kind, victim->reg, 0};
+      spill(victim->value);
+      *victim = {it.end, it.value, victim->reg};
+    } else {
+      spill(it.value);
+    }
+  }
+
+  calleeSaved.clear();
+  for (auto r : calleeSavedGpr) {
+    for (auto& l : locations) {
+      if (l.kind == Location::Gpr && l.reg == r) {
+        calleeSaved.push_back(r);
+        break;
+      }
+    }
+  }
+}
+
+void RegisterAllocator::spill(IrValue v) {
+  locations[v] = {Location::Stack, RAX, spillSlots++};
+}
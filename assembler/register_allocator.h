@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "ir.h"
+#include "opcode.h"
+
+// Where the value of an instruction lives for its whole lifetime. Stack is
+// an 8 byte spill slot of the frame, numbered from 0.
+struct Location {
+  enum Kind : uint8_t {
+    None,
+    Gpr,
+    Xmm,
+    Stack,
+  };
+
+  Kind kind = None;
+  Register reg = RAX;
+  uint32_t slot = 0;
+
+  bool operator ==(const Location& o) const {
+    return kind == o.kind && (kind == Stack ? slot == o.slot : reg == o.reg);
+  }
+  bool operator !=(const Location& o) const { return !(*this == o); }
+  bool isReg() const { return kind == Gpr || kind == Xmm; }
+};
+
+// constants and addresses of storage, rebuilt at each use instead of living somewhere
+bool isRematerialized(const IrInstr&);
+
+// Linear scan over the live intervals of the values of a function. Blocks
+// are laid out in their order, instruction k reads its operands at 2k and
+// writes its value at 2k + 1; an interval spans from the first to the last
+// point the value is live at, holes included.
+//
+// rax, rcx, rdx, rsi, rdi, r11, xmm0 and xmm1 are left to the lowering as
+// scratch. A value live across a call or a print goes to a callee saved
+// register (rbx, r12 - r15) or to the stack; the interval that ends last
+// is spilled when the registers run out.
+class RegisterAllocator {
+ public:
+  RegisterAllocator(const IrFunction&);
+
+  const std::vector<Location>& getLocations() const { return locations; }
+  uint32_t getSpillSlots() const { return spillSlots; }
+  // callee saved registers the function writes
+  const std::vector<Register>& getCalleeSaved() const { return calleeSaved; }
+
+ private:
+  struct Interval {
+    IrValue value;
+    uint32_t start;
+    uint32_t end;
+    bool crossesCall;
+  };
+
+  void buildIntervals();
+  void scan();
+  void spill(IrValue);
+
+  const IrFunction& fn;
+  std::vector<Location> locations;
+  std::vector<Interval> intervals;
+  uint32_t spillSlots = 0;
+  std::vector<Register> calleeSaved;
+};
@@ -0,0 +1,359 @@
+#include "ir.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+IrFunction::IrFunction(Atom name, bool isMain) : name(name), isMain(isMain) {}
+
+IrBlockId IrFunction::addBlock() {
+  blocks.emplace_back();
+  return static_cast<IrBlockId>(blocks.size() - 1);
+}
+
+IrValue IrFunction::append(IrBlockId b, IrInstr i) {
+  i.block = b;
+  instrs.push_back(std::move(i));
+  auto v = static_cast<IrValue>(instrs.size() - 1);
+  blocks[b].instrs.push_back(v);
+  return v;
+}
+
+IrValue IrFunction::prepend(IrBlockId b, IrInstr i) {
+  i.block = b;
+  instrs.push_back(std::move(i));
+  auto v = static_cast<IrValue>(instrs.size() - 1);
+  auto& list = blocks[b].instrs;
+  auto pos = std::find_if(list.begin(), list.end(),
+                          [this](IrValue e) { return instrs[e].op != IrOp::Phi; });
+  list.insert(pos, v);
+  return v;
+}
+
+IrValue IrFunction::insert(IrBlockId b, std::size_t pos, IrInstr i) {
+  i.block = b;
+  instrs.push_back(std::move(i));
+  auto v = static_cast<IrValue>(instrs.size() - 1);
+  auto& list = blocks[b].instrs;
+  list.insert(list.begin() + pos, v);
+  return v;
+}
+
+void IrFunction::addEdge(IrBlockId from, IrBlockId to) {
+  blocks[from].succs.push_back(to);
+  blocks[to].preds.push_back(from);
+}
+
+uint32_t IrFunction::addSlot(uint64_t size) {
+  slots.push_back(size);
+  return static_cast<uint32_t>(slots.size() - 1);
+}
+
+bool IrFunction::isTerminated(IrBlockId b) const {
+  auto& list = blocks[b].instrs;
+  return !list.empty() && instrs[list.back()].isTerminator();
+}
+
+void IrFunction::removeUnreachable() {
+  const IrBlockId none = UINT32_MAX;
+  std::vector<IrBlockId> id(blocks.size(), none);
+  std::vector<IrBlockId> stack{0};
+  id[0] = 0;
+  while (!stack.empty()) {
+    auto b = stack.back();
+    stack.pop_back();
+    for (auto s : blocks[b].succs) {
+      if (id[s] == none) {
+        id[s] = 0;
+        stack.push_back(s);
+      }
+    }
+  }
+  IrBlockId count = 0;
+  for (auto& e : id) {
+    if (e != none) {
+      e = count++;
+    }
+  }
+  if (count == blocks.size()) {
+    return;
+  }
+
+  std::vector<IrBlock> live;
+  live.reserve(count);
+  for (IrBlockId b = 0; b < blocks.size(); ++b) {
+    if (id[b] == none) {
+      continue;
+    }
+    auto block = std::move(blocks[b]);
+    std::vector<IrBlockId> preds;
+    for (auto p : block.preds) {
+      if (id[p] != none) {
+        preds.push_back(id[p]);
+      }
+    }
+    block.preds = std::move(preds);
+    for (auto& s : block.succs) {
+      s = id[s];
+    }
+    for (auto v : block.instrs) {
+      auto& i = instrs[v];
+      i.block = id[b];
+      if (i.op != IrOp::Phi) {
+        continue;
+      }
+      std::size_t keep = 0;
+      for (std::size_t k = 0; k < i.args.size(); ++k) {
+        if (id[i.from[k]] != none) {
+          i.args[keep] = i.args[k];
+          i.from[keep] = id[i.from[k]];
+          ++keep;
+        }
+      }
+      i.args.resize(keep);
+      i.from.resize(keep);
+    }
+    live.push_back(std::move(block));
+  }
+  blocks = std::move(live);
+}
+
+void IrFunction::verify() const {
+  auto fail = [this](const std::string& s) {
+    throw std::logic_error("IR of " + name.str() + ": " + s);
+  };
+  std::vector<bool> defined(instrs.size(), false);
+  for (IrBlockId b = 0; b < blocks.size(); ++b) {
+    for (auto v : blocks[b].instrs) {
+      if (v >= instrs.size() || defined[v]) {
+        fail("instruction %" + std::to_string(v) + " placed twice");
+      }
+      defined[v] = true;
+    }
+  }
+  for (IrBlockId b = 0; b < blocks.size(); ++b) {
+    auto& block = blocks[b];
+    auto name = "block b" + std::to_string(b);
+    if (!isTerminated(b)) {
+      fail(name + " has no terminator");
+    }
+    bool isPhi = true;
+    for (std::size_t k = 0; k < block.instrs.size(); ++k) {
+      auto& i = instrs[block.instrs[k]];
+      if (i.block != b) {
+        fail(name + " holds an instruction of another block");
+      }
+      if (i.isTerminator() && k + 1 != block.instrs.size()) {
+        fail(name + " has a terminator in the middle");
+      }
+      if (i.op == IrOp::Phi) {
+        if (!isPhi) {
+          fail(name + " has a phi after other instructions");
+        }
+        auto from = i.from;
+        auto preds = block.preds;
+        std::sort(from.begin(), from.end());
+        std::sort(preds.begin(), preds.end());
+        if (from != preds || i.args.size() != i.from.size()) {
+          fail(name + " has a phi not matching its predecessors");
+        }
+      } else {
+        isPhi = false;
+      }
+      for (auto a : i.args) {
+        if (a >= instrs.size() || !defined[a] || instrs[a].type == IrType::Void) {
+          fail(name + " uses an undefined value %" + std::to_string(a));
+        }
+      }
+    }
+    std::size_t numSucc = 0;
+    switch (instrs[block.instrs.back()].op) {
+      case IrOp::Jump: numSucc = 1; break;
+      case IrOp::Branch: numSucc = 2; break;
+      default: break;
+    }
+    if (block.succs.size() != numSucc) {
+      fail(name + " has a wrong number of successors");
+    }
+    for (auto s : block.succs) {
+      auto& p = blocks[s].preds;
+      if (std::count(p.begin(), p.end(), b) != std::count(block.succs.begin(), block.succs.end(), s)) {
+        fail(name + " is not a predecessor of its successor");
+      }
+    }
+  }
+}
+
+const char* toString(IrType t) {
+  switch (t) {
+    case IrType::Void: return "void";
+    case IrType::Int: return "int";
+    case IrType::Double: return "double";
+    case IrType::Ptr: return "ptr";
+  }
+  return "";
+}
+
+const char* toString(IrOp op) {
+  switch (op) {
+    case IrOp::Const: return "const";
+    case IrOp::ConstDouble: return "const";
+    case IrOp::Global: return "global";
+    case IrOp::String: return "string";
+    case IrOp::FunctionAddr: return "function";
+    case IrOp::Local: return "local";
+    case IrOp::Param: return "param";
+    case IrOp::Result: return "result";
+    case IrOp::Load: return "load";
+    case IrOp::Store: return "store";
+    case IrOp::MemCopy: return "memcopy";
+    case IrOp::Add: return "add";
+    case IrOp::Sub: return "sub";
+    case IrOp::Mul: return "mul";
+    case IrOp::Div: return "div";
+    case IrOp::Mod: return "mod";
+    case IrOp::Shl: return "shl";
+    case IrOp::Shr: return "shr";
+    case IrOp::And: return "and";
+    case IrOp::Or: return "or";
+    case IrOp::Xor: return "xor";
+    case IrOp::Neg: return "neg";
+    case IrOp::Not: return "not";
+    case IrOp::FAdd: return "fadd";
+    case IrOp::FSub: return "fsub";
+    case IrOp::FMul: return "fmul";
+    case IrOp::FDiv: return "fdiv";
+    case IrOp::Cmp: return "cmp";
+    case IrOp::FCmp: return "fcmp";
+    case IrOp::IntToDouble: return "itod";
+    case IrOp::DoubleToInt: return "dtoi";
+    case IrOp::RoundToInt: return "round";
+    case IrOp::Call: return "call";
+    case IrOp::Print: return "print";
+    case IrOp::OpenArrayCopy: return "openarraycopy";
+    case IrOp::Phi: return "phi";
+    case IrOp::Jump: return "jump";
+    case IrOp::Branch: return "branch";
+    case IrOp::Return: return "return";
+  }
+  return "";
+}
+
+static const char* toString(IrCond c) {
+  switch (c) {
+    case IrCond::Eq: return "eq";
+    case IrCond::Ne: return "ne";
+    case IrCond::Lt: return "lt";
+    case IrCond::Le: return "le";
+    case IrCond::Gt: return "gt";
+    case IrCond::Ge: return "ge";
+  }
+  return "";
+}
+
+static const char* toString(IrFormat f) {
+  switch (f) {
+    case IrFormat::Int: return "int";
+    case IrFormat::Double: return "double";
+    case IrFormat::Char: return "char";
+    case IrFormat::String: return "string";
+    case IrFormat::NewLine: return "newline";
+  }
+  return "";
+}
+
+void IrFunction::print(std::ostream& os) const {
+  os << "function " << (isMain ? "main" : name.str()) << "(";
+  for (std::size_t k = 0; k < params.size(); ++k) {
+    os << (k ? ", " : "") << params[k];
+  }
+  os << ")";
+  if (resultSize != 0) {
+    os << " result " << resultSize;
+  }
+  os << "\n";
+  for (std::size_t k = 0; k < slots.size(); ++k) {
+    os << "  slot s" << k << " " << slots[k] << "\n";
+  }
+  for (IrBlockId b = 0; b < blocks.size(); ++b) {
+    os << "b" << b << ":";
+    if (!blocks[b].preds.empty()) {
+      os << " ; preds";
+      for (auto p : blocks[b].preds) {
+        os << " b" << p;
+      }
+    }
+    os << "\n";
+    for (auto v : blocks[b].instrs) {
+      auto& i = instrs[v];
+      os << "  ";
+      if (i.type != IrType::Void) {
+        os << "%" << v << ":" << toString(i.type) << " = ";
+      }
+      os << toString(i.op);
+      switch (i.op) {
+        case IrOp::Const:
+        case IrOp::Param:
+        case IrOp::MemCopy:
+        case IrOp::RoundToInt:
+        case IrOp::OpenArrayCopy:
+        case IrOp::Call: {
+          os << " " << i.imm;
+          break;
+        }
+        case IrOp::ConstDouble: {
+          os << " " << i.number;
+          break;
+        }
+        case IrOp::Global:
+        case IrOp::FunctionAddr: {
+          os << " " << i.name.str();
+          break;
+        }
+        case IrOp::String:
+        case IrOp::Local: {
+          os << (i.op == IrOp::Local ? " s" : " str") << i.imm;
+          break;
+        }
+        case IrOp::Cmp:
+        case IrOp::FCmp: {
+          os << " " << toString(static_cast<IrCond>(i.imm));
+          break;
+        }
+        case IrOp::Print: {
+          os << " " << toString(static_cast<IrFormat>(i.imm));
+          break;
+        }
+        default:
+          break;
+      }
+      for (std::size_t k = 0; k < i.args.size(); ++k) {
+        os << (k ? ", " : " ");
+        if (i.op == IrOp::Phi) {
+          os << "[%" << i.args[k] << ", b" << i.from[k] << "]";
+        } else {
+          os << "%" << i.args[k];
+          if (i.op == IrOp::Call && k > 0 && k <= i.argSize.size() && i.argSize[k - 1] != 0) {
+            os << " copy " << i.argSize[k - 1];
+          }
+        }
+      }
+      for (std::size_t k = 0; k < blocks[b].succs.size() && i.isTerminator(); ++k) {
+        os << (k || !i.args.empty() ? ", b" : " b") << blocks[b].succs[k];
+      }
+      os << "\n";
+    }
+  }
+}
+
+void IrModule::print(std::ostream& os) const {
+  for (auto& g : globals) {
+    os << "global " << g.name.str() << " " << g.size << "\n";
+  }
+  for (std::size_t k = 0; k < strings.size(); ++k) {
+    os << "string str" << k << " '" << strings[k] << "'\n";
+  }
+  for (auto& f : functions) {
+    os << "\n";
+    f.print(os);
+  }
+}
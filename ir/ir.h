@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "atom.h"
+
+// Three-address code in SSA form between the checked ast and the assembler.
+// Every instruction of a function lives in one array, a value is the index
+// of the instruction that defines it and is assigned once. A function is a
+// list of basic blocks; a block holds its phis first and ends with exactly
+// one terminator, its successors are kept in the block.
+using IrValue = uint32_t;
+using IrBlockId = uint32_t;
+
+// Int covers integer, char and boolean, Ptr addresses and pointer values.
+// Records and arrays are never values, an expression of such a type gives
+// the address of its storage.
+enum class IrType : uint8_t {
+  Void,
+  Int,
+  Double,
+  Ptr,
+};
+
+enum class IrOp : uint8_t {
+  // constants and addresses, imm: Const - value, String - index in
+  // IrModule::strings, Local - slot, Param - parameter index
+  Const,
+  ConstDouble,
+  Global,
+  String,
+  FunctionAddr,
+  Local,
+  Param,
+  Result,
+
+  // memory, one word; MemCopy(dst, src) copies imm bytes
+  Load,
+  Store,
+  MemCopy,
+
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Mod,
+  Shl,
+  Shr,
+  And,
+  Or,
+  Xor,
+  Neg,
+  Not,
+
+  FAdd,
+  FSub,
+  FMul,
+  FDiv,
+
+  // imm - IrCond, result 0 or 1
+  Cmp,
+  FCmp,
+
+  IntToDouble,
+  DoubleToInt,
+  // imm - rounding mode of roundsd
+  RoundToInt,
+
+  // args: callee, arguments and, for a function with a record or array
+  // result, the address the result is copied to. imm - bytes of the result
+  Call,
+  // imm - IrFormat
+  Print,
+  // args: parameter address; copies a value open array to the frame, imm - element size
+  OpenArrayCopy,
+
+  // args[i] comes from the block from[i]
+  Phi,
+
+  // terminators: Branch goes to succs[0] on non zero, else to succs[1]
+  Jump,
+  Branch,
+  Return,
+};
+
+enum class IrCond : uint8_t {
+  Eq,
+  Ne,
+  Lt,
+  Le,
+  Gt,
+  Ge,
+};
+
+enum class IrFormat : uint8_t {
+  Int,
+  Double,
+  Char,
+  String,
+  NewLine,
+};
+
+struct IrInstr {
+  IrOp op;
+  IrType type = IrType::Void;
+  IrBlockId block = 0;
+  int64_t imm = 0;
+  double number = 0;
+  // Global, FunctionAddr
+  Atom name;
+  std::vector<IrValue> args;
+  // Phi: predecessor of each argument
+  std::vector<IrBlockId> from;
+  // Call: bytes copied from a record or array argument, 0 - the argument is one word
+  std::vector<uint64_t> argSize;
+
+  bool isTerminator() const { return op == IrOp::Jump || op == IrOp::Branch || op == IrOp::Return; }
+};
+
+struct IrBlock {
+  std::vector<IrValue> instrs;
+  std::vector<IrBlockId> preds;
+  std::vector<IrBlockId> succs;
+};
+
+class IrFunction {
+ public:
+  IrFunction(Atom name, bool isMain);
+
+  IrBlockId addBlock();
+  IrValue append(IrBlockId b, IrInstr i);
+  // placed after the phis of the block
+  IrValue prepend(IrBlockId b, IrInstr i);
+  // placed at the position in the block
+  IrValue insert(IrBlockId b, std::size_t pos, IrInstr i);
+  void addEdge(IrBlockId from, IrBlockId to);
+  uint32_t addSlot(uint64_t size);
+
+  IrInstr& get(IrValue v) { return instrs[v]; }
+  const IrInstr& get(IrValue v) const { return instrs[v]; }
+  bool isTerminated(IrBlockId b) const;
+
+  // drops the blocks not reached from the entry and renumbers the rest
+  void removeUnreachable();
+  // throws std::logic_error on a malformed function
+  void verify() const;
+  void print(std::ostream&) const;
+
+  Atom name;
+  bool isMain;
+  // bytes of each parameter in declaration order
+  std::vector<uint64_t> params;
+  uint64_t resultSize = 0;
+  // bytes of each frame slot
+  std::vector<uint64_t> slots;
+  std::vector<IrInstr> instrs;
+  // blocks[0] is the entry
+  std::vector<IrBlock> blocks;
+};
+
+struct IrGlobal {
+  Atom name;
+  uint64_t size;
+};
+
+struct IrModule {
+  std::vector<IrGlobal> globals;
+  std::vector<std::string> strings;
+  // functions[0] is the main program
+  std::vector<IrFunction> functions;
+
+  void print(std::ostream&) const;
+};
+
+const char* toString(IrOp);
+const char* toString(IrType);
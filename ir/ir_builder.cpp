@@ -0,0 +1,671 @@
+#include "ir_builder.h"
+
+#include <stdexcept>
+
+#include "type_checker.h"
+
+namespace {
+
+ptr_Type resolve(ptr_Type t) {
+  while (t->getKind() == NodeKind::Alias || t->getKind() == NodeKind::ForwardType) {
+    t = static_cast<Alias*>(t)->getRefType();
+  }
+  return t;
+}
+
+// boolean is not trivial for the stack generator, here it is one word as well
+bool isScalar(const ptr_Type& t) {
+  return t->isTrivial() || t->isBool();
+}
+
+IrType irType(const ptr_Type& t) {
+  if (t->isDouble()) {
+    return IrType::Double;
+  }
+  if (t->isInt() || t->isChar() || t->isBool()) {
+    return IrType::Int;
+  }
+  return IrType::Ptr;
+}
+
+bool isFunction(Symbol& s) {
+  return s.getKind() == NodeKind::Function || s.getKind() == NodeKind::ForwardFunction;
+}
+
+// the variable keeps a pointer to the argument instead of its value
+bool isByReference(Symbol& s) {
+  if (s.getKind() != NodeKind::ParamVar) {
+    return false;
+  }
+  auto& p = static_cast<ParamVar&>(s);
+  return p.getVarType()->isOpenArray() || p.getSpec() != ParamSpec::NotSpec;
+}
+
+IrCond toCond(TokenType t) {
+  switch (t) {
+    case TokenType::Equals: return IrCond::Eq;
+    case TokenType::NotEquals: return IrCond::Ne;
+    case TokenType::StrictLess: return IrCond::Lt;
+    case TokenType::LessOrEquals: return IrCond::Le;
+    case TokenType::StrictGreater: return IrCond::Gt;
+    default: return IrCond::Ge;
+  }
+}
+
+} // namespace
+
+IrModule IrBuilder::build(MainFunction& m) {
+  IrModule result;
+  module = &result;
+  for (auto& v : m.getTable().tableVariable) {
+    result.globals.push_back({v->getAtom(), v->getVarType()->size()});
+  }
+  buildFunction(m, true);
+  for (auto& f : m.getTable().tableFunction) {
+    if (!f->isBuildIn()) {
+      buildFunction(*f, false);
+    }
+  }
+  module = nullptr;
+  return result;
+}
+
+void IrBuilder::buildFunction(SymFun& f, bool isMain) {
+  fn = &module->functions.emplace_back(f.getAtom(), isMain);
+  storage.clear();
+  loops.clear();
+  block = fn->addBlock();
+
+  if (!isMain) {
+    auto s = f.getSignature();
+    int64_t index = 0;
+    for (auto& p : s->getParamList()) {
+      uint64_t size = 8;
+      if (p->getVarType()->isOpenArray()) {
+        size = 16; // address and high bound
+      } else if (p->getSpec() == ParamSpec::NotSpec) {
+        size = p->getVarType()->size();
+      }
+      fn->params.push_back(size);
+      IrInstr i{IrOp::Param, IrType::Ptr};
+      i.imm = index++;
+      storage[p] = fn->append(block, std::move(i));
+    }
+    if (!s->isProcedure()) {
+      fn->resultSize = s->getReturnType()->size();
+      for (auto& v : f.getTable().tableVariable) {
+        if (v->getAtom() == f.getAtom()) {
+          storage[v] = emit(IrOp::Result, IrType::Ptr);
+        }
+      }
+    }
+    for (auto& p : s->getParamList()) {
+      if (p->getVarType()->isOpenArray() && p->getSpec() == ParamSpec::NotSpec) {
+        auto elem = static_cast<OpenArray*>(resolve(p->getVarType()))->getRefType();
+        emit(IrOp::OpenArrayCopy, IrType::Void, {storage[p]}, elem->size());
+      }
+    }
+  }
+
+  dispatch(*this, *f.getBody());
+  if (!fn->isTerminated(block)) {
+    emit(IrOp::Return, IrType::Void);
+  }
+  fn->removeUnreachable();
+  fn->verify();
+  fn = nullptr;
+}
+
+IrValue IrBuilder::emit(IrOp op, IrType type, std::vector<IrValue> args, int64_t imm) {
+  IrInstr i{op, type};
+  i.args = std::move(args);
+  i.imm = imm;
+  return fn->append(block, std::move(i));
+}
+
+IrValue IrBuilder::constant(int64_t c) {
+  return emit(IrOp::Const, IrType::Int, {}, c);
+}
+
+IrValue IrBuilder::offset(IrValue base, IrValue index, int64_t scale) {
+  auto& i = fn->get(index);
+  if (i.op == IrOp::Const) {
+    auto c = i.imm * scale;
+    return c == 0 ? base : emit(IrOp::Add, IrType::Ptr, {base, constant(c)});
+  }
+  if (scale != 1) {
+    index = emit(IrOp::Mul, IrType::Int, {index, constant(scale)});
+  }
+  return emit(IrOp::Add, IrType::Ptr, {base, index});
+}
+
+IrValue IrBuilder::temp(uint64_t size) {
+  IrInstr i{IrOp::Local, IrType::Ptr};
+  i.imm = fn->addSlot(size);
+  return fn->prepend(0, std::move(i));
+}
+
+void IrBuilder::jump(IrBlockId target) {
+  emit(IrOp::Jump, IrType::Void);
+  fn->addEdge(block, target);
+}
+
+void IrBuilder::branch(IrValue c, IrBlockId ifTrue, IrBlockId ifFalse) {
+  emit(IrOp::Branch, IrType::Void, {c});
+  fn->addEdge(block, ifTrue);
+  fn->addEdge(block, ifFalse);
+}
+
+void IrBuilder::startDead() {
+  block = fn->addBlock();
+}
+
+IrValue IrBuilder::rvalue(Expression& e) {
+  bool was = isAddress;
+  isAddress = false;
+  dispatch(*this, e);
+  isAddress = was;
+  return value;
+}
+
+IrValue IrBuilder::address(Expression& e) {
+  ptr_Expr p = &e;
+  if (!LvalueChecker::is(p)) {
+    // a value passed for a const parameter or a cast: give it storage
+    auto v = rvalue(e);
+    auto& type = e.getNodeType();
+    if (!isScalar(type)) {
+      return v;
+    }
+    auto t = temp(8);
+    emit(IrOp::Store, IrType::Void, {t, v});
+    return t;
+  }
+  bool was = isAddress;
+  isAddress = true;
+  dispatch(*this, e);
+  isAddress = was;
+  return value;
+}
+
+IrValue IrBuilder::storageOf(Symbol& s) {
+  if (auto it = storage.find(&s); it != storage.end()) {
+    return it->second;
+  }
+  IrInstr i{IrOp::Local, IrType::Ptr};
+  switch (s.getKind()) {
+    case NodeKind::LocalVar: {
+      i.imm = fn->addSlot(static_cast<SymVar&>(s).getVarType()->size());
+      break;
+    }
+    case NodeKind::GlobalVar: {
+      i.op = IrOp::Global;
+      i.name = s.getAtom();
+      break;
+    }
+    case NodeKind::Function:
+    case NodeKind::ForwardFunction: {
+      i.op = IrOp::FunctionAddr;
+      i.name = s.getAtom();
+      break;
+    }
+    default:
+      throw std::logic_error("IR: no storage for " + s.getSymbolName());
+  }
+  auto v = fn->prepend(0, std::move(i));
+  storage.emplace(&s, v);
+  return v;
+}
+
+IrValue IrBuilder::load(IrValue addr, ptr_Type& t) {
+  if (!isScalar(t)) {
+    return addr;
+  }
+  return emit(IrOp::Load, irType(t), {addr});
+}
+
+void IrBuilder::assign(IrValue addr, IrValue v, ptr_Type& t) {
+  if (isScalar(t)) {
+    emit(IrOp::Store, IrType::Void, {addr, v});
+  } else {
+    emit(IrOp::MemCopy, IrType::Void, {addr, v}, t->size());
+  }
+}
+
+void IrBuilder::visit(Variable& v) {
+  auto s = v.getSymbol();
+  if (s == nullptr) {
+    throw std::logic_error("IR: variable " + v.getSubToken().getString() + " is not bound");
+  }
+  auto addr = storageOf(*s);
+  if (isFunction(*s)) {
+    value = addr;
+    return;
+  }
+  if (isByReference(*s)) {
+    addr = emit(IrOp::Load, IrType::Ptr, {addr});
+  }
+  value = isAddress ? addr : load(addr, v.getNodeType());
+}
+
+void IrBuilder::visit(Literal& l) {
+  auto& t = l.getNodeType();
+  auto& token = l.getSubToken();
+  if (t->isInt()) {
+    value = constant(static_cast<int64_t>(token.getInt()));
+  } else if (t->isDouble()) {
+    value = emit(IrOp::ConstDouble, IrType::Double);
+    fn->get(value).number = static_cast<double>(token.getDouble());
+  } else if (t->isChar()) {
+    auto s = token.getString();
+    value = constant(s.empty() ? 0 : static_cast<unsigned char>(s[0]));
+  } else if (t->isString()) {
+    module->strings.push_back(token.getString());
+    value = emit(IrOp::String, IrType::Ptr, {}, module->strings.size() - 1);
+  } else if (token.is(TokenType::True)) {
+    value = constant(1);
+  } else {
+    value = emit(IrOp::Const, irType(t)); // false and nil
+  }
+}
+
+IrValue IrBuilder::logical(BinaryOperation& b) {
+  bool isAnd = b.getOp().is(TokenType::And);
+  auto left = rvalue(*b.getSubLeft());
+  auto shortValue = constant(isAnd ? 0 : 1);
+  auto shortFrom = block;
+  auto rightBlock = fn->addBlock();
+  auto join = fn->addBlock();
+  if (isAnd) {
+    branch(left, rightBlock, join);
+  } else {
+    branch(left, join, rightBlock);
+  }
+  block = rightBlock;
+  auto right = rvalue(*b.getSubRight());
+  right = emit(IrOp::Cmp, IrType::Int, {right, constant(0)}, static_cast<int64_t>(IrCond::Ne));
+  auto rightFrom = block;
+  jump(join);
+
+  block = join;
+  IrInstr phi{IrOp::Phi, IrType::Int};
+  phi.args = {shortValue, right};
+  phi.from = {shortFrom, rightFrom};
+  return fn->append(block, std::move(phi));
+}
+
+void IrBuilder::visit(BinaryOperation& b) {
+  auto t = b.getOp().getTokenType();
+  if ((t == TokenType::And || t == TokenType::Or) && b.getNodeType()->isBool()) {
+    value = logical(b);
+    return;
+  }
+  auto left = rvalue(*b.getSubLeft());
+  auto right = rvalue(*b.getSubRight());
+  bool isDouble = b.getNodeType()->isDouble();
+  IrOp op;
+  switch (t) {
+    case TokenType::Plus: op = isDouble ? IrOp::FAdd : IrOp::Add; break;
+    case TokenType::Minus: op = isDouble ? IrOp::FSub : IrOp::Sub; break;
+    case TokenType::Asterisk: op = isDouble ? IrOp::FMul : IrOp::Mul; break;
+    case TokenType::Slash: op = IrOp::FDiv; break;
+    case TokenType::Div: op = IrOp::Div; break;
+    case TokenType::Mod: op = IrOp::Mod; break;
+    case TokenType::ShiftLeft:
+    case TokenType::Shl: op = IrOp::Shl; break;
+    case TokenType::ShiftRight:
+    case TokenType::Shr: op = IrOp::Shr; break;
+    case TokenType::And: op = IrOp::And; break;
+    case TokenType::Or: op = IrOp::Or; break;
+    case TokenType::Xor: op = IrOp::Xor; break;
+    case TokenType::Equals:
+    case TokenType::NotEquals:
+    case TokenType::StrictLess:
+    case TokenType::StrictGreater:
+    case TokenType::LessOrEquals:
+    case TokenType::GreaterOrEquals: {
+      op = b.getSubLeft()->getNodeType()->isDouble() ? IrOp::FCmp : IrOp::Cmp;
+      value = emit(op, IrType::Int, {left, right}, static_cast<int64_t>(toCond(t)));
+      return;
+    }
+    default:
+      throw std::logic_error("IR: not valid binary operation " + toString(t));
+  }
+  value = emit(op, irType(b.getNodeType()), {left, right});
+}
+
+void IrBuilder::visit(UnaryOperation& u) {
+  auto& type = u.getNodeType();
+  switch (u.getOp().getTokenType()) {
+    case TokenType::Minus: {
+      auto v = rvalue(*u.getSubNode());
+      if (type->isDouble()) {
+        // 0 - x as the stack generator does, -0.0 is never produced
+        auto zero = emit(IrOp::ConstDouble, IrType::Double);
+        value = emit(IrOp::FSub, IrType::Double, {zero, v});
+      } else {
+        value = emit(IrOp::Neg, IrType::Int, {v});
+      }
+      return;
+    }
+    case TokenType::Plus: {
+      value = rvalue(*u.getSubNode());
+      return;
+    }
+    case TokenType::Not: {
+      auto v = rvalue(*u.getSubNode());
+      if (type->isBool()) {
+        value = emit(IrOp::Xor, IrType::Int, {v, constant(1)});
+      } else {
+        value = emit(IrOp::Not, IrType::Int, {v});
+      }
+      return;
+    }
+    case TokenType::At: {
+      value = address(*u.getSubNode());
+      return;
+    }
+    case TokenType::Caret: {
+      bool want = isAddress;
+      auto addr = rvalue(*u.getSubNode());
+      value = want ? addr : load(addr, type);
+      return;
+    }
+    default:
+      throw std::logic_error("IR: not valid unary operation " + toString(u.getOp().getTokenType()));
+  }
+}
+
+void IrBuilder::visit(ArrayAccess& a) {
+  bool want = isAddress;
+  auto base = address(*a.getSubNode());
+  auto t = a.getSubNode()->getNodeType();
+  auto& list = a.getListIndex();
+  std::size_t k = 0;
+  while (k < list.size()) {
+    t = resolve(t);
+    if (t->isPointer()) {
+      auto elem = t->getPointerBase();
+      base = emit(IrOp::Load, IrType::Ptr, {base});
+      base = offset(base, rvalue(*list[k++]), elem->size());
+      t = elem;
+    } else if (t->isOpenArray()) {
+      auto elem = static_cast<OpenArray*>(t)->getRefType();
+      base = offset(base, rvalue(*list[k++]), elem->size());
+      t = elem;
+    } else {
+      auto s = t->getStaticArray();
+      auto& bounds = s->getBounds();
+      auto& strides = s->getLayout().strides;
+      int64_t elemSize = s->getRefType()->size();
+      std::size_t dim = 0;
+      for (auto it = bounds.begin(); it != bounds.end() && k < list.size(); ++it, ++dim, ++k) {
+        auto index = rvalue(*list[k]);
+        int64_t low = it->first;
+        if (low != 0) {
+          auto& i = fn->get(index);
+          index = i.op == IrOp::Const ? constant(i.imm - low)
+                                      : emit(IrOp::Sub, IrType::Int, {index, constant(low)});
+        }
+        base = offset(base, index, strides[dim] * elemSize);
+      }
+      if (dim < bounds.size()) {
+        break; // a part of the dimensions, the result is an array
+      }
+      t = s->getRefType();
+    }
+  }
+  value = want ? base : load(base, a.getNodeType());
+}
+
+void IrBuilder::visit(RecordAccess& r) {
+  bool want = isAddress;
+  auto base = address(*r.getSubNode());
+  auto record = r.getSubNode()->getNodeType()->getRecord();
+  base = offset(base, constant(record->offset(r.getField().getAtom())), 1);
+  value = want ? base : load(base, r.getNodeType());
+}
+
+void IrBuilder::visit(Cast& c) {
+  if (isAddress) {
+    value = address(*c.getSubNode());
+    return;
+  }
+  auto v = rvalue(*c.getSubNode());
+  auto& from = c.getSubNode()->getNodeType();
+  auto& to = c.getNodeType();
+  if (from->isDouble() && to->isInt()) {
+    value = emit(IrOp::DoubleToInt, IrType::Int, {v});
+  } else if (from->isInt() && to->isDouble()) {
+    value = emit(IrOp::IntToDouble, IrType::Double, {v});
+  } else {
+    value = v;
+  }
+}
+
+std::pair<IrValue, IrValue> IrBuilder::openArray(Expression& e) {
+  auto& t = e.getNodeType();
+  if (t->isOpenArray()) {
+    if (e.getKind() != NodeKind::Variable) {
+      throw std::logic_error("IR: open array argument is not a parameter");
+    }
+    auto param = storageOf(*static_cast<Variable&>(e).getSymbol());
+    auto high = emit(IrOp::Load, IrType::Int, {offset(param, constant(8), 1)});
+    return {high, address(e)};
+  }
+  auto high = constant(t->getStaticArray()->getBounds().front().second);
+  return {high, address(e)};
+}
+
+IrValue IrBuilder::call(FunctionCall& f) {
+  auto& callee = *f.getSubNode();
+  auto s = callee.getNodeType()->getSignature();
+  std::vector<IrValue> args{0};
+  std::vector<uint64_t> sizes;
+  auto param = s->getParamList().begin();
+  for (auto& arg : f.getListParam()) {
+    auto& p = *param++;
+    if (p->getVarType()->isOpenArray()) {
+      auto [high, addr] = openArray(*arg);
+      args.insert(args.end(), {high, addr});
+      sizes.insert(sizes.end(), {0, 0});
+    } else if (p->getSpec() == ParamSpec::NotSpec) {
+      args.push_back(rvalue(*arg));
+      sizes.push_back(isScalar(p->getVarType()) ? 0 : p->getVarType()->size());
+    } else {
+      args.push_back(address(*arg));
+      sizes.push_back(0);
+    }
+  }
+  auto symbol = callee.getKind() == NodeKind::Variable ? static_cast<Variable&>(callee).getSymbol() : nullptr;
+  args[0] = symbol != nullptr && isFunction(*symbol) ? storageOf(*symbol) : rvalue(callee);
+
+  auto& type = s->getReturnType();
+  uint64_t size = s->isProcedure() ? 0 : type->size();
+  IrValue dest = 0;
+  if (!s->isProcedure() && !isScalar(type)) {
+    dest = temp(size);
+    args.push_back(dest);
+  }
+  auto v = emit(IrOp::Call, s->isProcedure() || dest ? IrType::Void : irType(type), std::move(args), size);
+  fn->get(v).argSize = std::move(sizes);
+  return dest ? dest : v;
+}
+
+IrValue IrBuilder::builtin(FunctionCall& f, SymFun& b) {
+  auto& params = f.getListParam();
+  switch (b.getKind()) {
+    case NodeKind::Write: {
+      for (auto& e : params) {
+        auto v = rvalue(*e);
+        auto& t = e->getNodeType();
+        IrFormat format = IrFormat::Int;
+        if (t->isString()) {
+          format = IrFormat::String;
+        } else if (t->isDouble()) {
+          format = IrFormat::Double;
+        } else if (t->isChar()) {
+          format = IrFormat::Char;
+        }
+        emit(IrOp::Print, IrType::Void, {v}, static_cast<int64_t>(format));
+      }
+      if (static_cast<Write&>(b).isNewLine()) {
+        emit(IrOp::Print, IrType::Void, {}, static_cast<int64_t>(IrFormat::NewLine));
+      }
+      return 0;
+    }
+    case NodeKind::Read: {
+      return 0;
+    }
+    case NodeKind::Trunc:
+    case NodeKind::Round: {
+      // roundsd mode: 11 - toward zero, 8 - to nearest
+      int64_t mode = b.getKind() == NodeKind::Trunc ? 11 : 8;
+      return emit(IrOp::RoundToInt, IrType::Int, {rvalue(*params.front())}, mode);
+    }
+    case NodeKind::Succ:
+    case NodeKind::Prev: {
+      auto v = rvalue(*params.front());
+      auto op = b.getKind() == NodeKind::Succ ? IrOp::Add : IrOp::Sub;
+      return emit(op, irType(f.getNodeType()), {v, constant(1)});
+    }
+    case NodeKind::Chr:
+    case NodeKind::Ord: {
+      return rvalue(*params.front());
+    }
+    case NodeKind::High:
+    case NodeKind::Low: {
+      auto& t = params.front()->getNodeType();
+      if (t->isOpenArray()) {
+        if (b.getKind() == NodeKind::Low) {
+          return constant(0);
+        }
+        return openArray(*params.front()).first;
+      }
+      auto& bound = t->getStaticArray()->getBounds().front();
+      return constant(b.getKind() == NodeKind::Low ? bound.first : bound.second);
+    }
+    case NodeKind::Exit: {
+      auto& e = static_cast<Exit&>(b);
+      if (!e.getReturnType()->isVoid() && !params.empty()) {
+        auto v = rvalue(*params.front());
+        assign(storageOf(*e.getVar()), v, e.getReturnType());
+      }
+      emit(IrOp::Return, IrType::Void);
+      startDead();
+      return 0;
+    }
+    default:
+      throw std::logic_error("IR: unknown embedded function " + b.getSymbolName());
+  }
+}
+
+void IrBuilder::visit(FunctionCall& f) {
+  if (auto b = f.getSubNode()->getEmbeddedFunction(); b != nullptr) {
+    value = builtin(f, *b);
+  } else {
+    value = call(f);
+  }
+}
+
+void IrBuilder::visit(AssignmentStmt& a) {
+  auto right = rvalue(*a.getSubRight());
+  auto addr = address(*a.getSubLeft());
+  auto& type = a.getSubLeft()->getNodeType();
+  auto t = a.getOp().getTokenType();
+  if (t != TokenType::Assignment) {
+    bool isDouble = type->isDouble();
+    IrOp op;
+    switch (t) {
+      case TokenType::AssignmentWithPlus: op = isDouble ? IrOp::FAdd : IrOp::Add; break;
+      case TokenType::AssignmentWithMinus: op = isDouble ? IrOp::FSub : IrOp::Sub; break;
+      case TokenType::AssignmentWithAsterisk: op = isDouble ? IrOp::FMul : IrOp::Mul; break;
+      default: op = IrOp::FDiv; break;
+    }
+    auto left = emit(IrOp::Load, irType(type), {addr});
+    right = emit(op, irType(type), {left, right});
+  }
+  assign(addr, right, type);
+}
+
+void IrBuilder::visit(FunctionCallStmt& f) {
+  rvalue(*f.getSubNode());
+}
+
+void IrBuilder::visit(BlockStmt& b) {
+  for (auto& e : b.getBlock()) {
+    dispatch(*this, *e);
+  }
+}
+
+void IrBuilder::visit(IfStmt& i) {
+  auto c = rvalue(*i.getCondition());
+  auto then = fn->addBlock();
+  auto end = fn->addBlock();
+  auto otherwise = i.getSubElse() != nullptr ? fn->addBlock() : end;
+  branch(c, then, otherwise);
+  block = then;
+  dispatch(*this, *i.getSubThen());
+  jump(end);
+  if (i.getSubElse() != nullptr) {
+    block = otherwise;
+    dispatch(*this, *i.getSubElse());
+    jump(end);
+  }
+  block = end;
+}
+
+void IrBuilder::visit(WhileStmt& w) {
+  auto header = fn->addBlock();
+  auto body = fn->addBlock();
+  auto end = fn->addBlock();
+  jump(header);
+  block = header;
+  branch(rvalue(*w.getCondition()), body, end);
+  block = body;
+  loops.emplace_back(header, end);
+  dispatch(*this, *w.getSubNode());
+  loops.pop_back();
+  jump(header);
+  block = end;
+}
+
+void IrBuilder::visit(ForStmt& f) {
+  auto low = rvalue(*f.getLow());
+  auto var = address(*f.getVar());
+  auto high = rvalue(*f.getHigh());
+  emit(IrOp::Store, IrType::Void, {var, low});
+
+  auto header = fn->addBlock();
+  auto body = fn->addBlock();
+  auto latch = fn->addBlock();
+  auto end = fn->addBlock();
+  jump(header);
+  block = header;
+  auto counter = emit(IrOp::Load, IrType::Int, {var});
+  auto cond = f.getDirect() ? IrCond::Ge : IrCond::Le;
+  branch(emit(IrOp::Cmp, IrType::Int, {high, counter}, static_cast<int64_t>(cond)), body, end);
+
+  block = body;
+  loops.emplace_back(latch, end);
+  dispatch(*this, *f.getSubNote());
+  loops.pop_back();
+  jump(latch);
+
+  block = latch;
+  counter = emit(IrOp::Load, IrType::Int, {var});
+  auto step = emit(f.getDirect() ? IrOp::Add : IrOp::Sub, IrType::Int, {counter, constant(1)});
+  emit(IrOp::Store, IrType::Void, {var, step});
+  jump(header);
+  block = end;
+}
+
+void IrBuilder::visit(BreakStmt&) {
+  jump(loops.back().second);
+  startDead();
+}
+
+void IrBuilder::visit(ContinueStmt&) {
+  jump(loops.back().first);
+  startDead();
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ir.h"
+#include "visitor.h"
+
+// Builds the IR of a checked program. Variables stay in memory and are
+// read and written with Load and Store. An expression of a scalar type
+// gives its value, of a record or array type the address of its storage.
+class IrBuilder final : public Visitor {
+ public:
+  IrModule build(MainFunction&);
+
+  using Visitor::visit;
+
+  void visit(Variable&) override;
+  void visit(Literal&) override;
+  void visit(BinaryOperation&) override;
+  void visit(UnaryOperation&) override;
+  void visit(ArrayAccess&) override;
+  void visit(RecordAccess&) override;
+  void visit(Cast&) override;
+  void visit(FunctionCall&) override;
+
+  void visit(AssignmentStmt&) override;
+  void visit(FunctionCallStmt&) override;
+  void visit(BlockStmt&) override;
+  void visit(IfStmt&) override;
+  void visit(WhileStmt&) override;
+  void visit(ForStmt&) override;
+  void visit(BreakStmt&) override;
+  void visit(ContinueStmt&) override;
+
+ private:
+  void buildFunction(SymFun&, bool isMain);
+
+  IrValue rvalue(Expression&);
+  IrValue address(Expression&);
+  IrValue storageOf(Symbol&);
+  IrValue load(IrValue address, ptr_Type&);
+  void assign(IrValue address, IrValue value, ptr_Type&);
+  IrValue logical(BinaryOperation&);
+  IrValue builtin(FunctionCall&, SymFun&);
+  IrValue call(FunctionCall&);
+  // high bound and address of an argument passed for an open array
+  std::pair<IrValue, IrValue> openArray(Expression&);
+  IrValue temp(uint64_t size);
+
+  IrValue emit(IrOp, IrType, std::vector<IrValue> args = {}, int64_t imm = 0);
+  IrValue constant(int64_t);
+  // base + index * scale, folded for constant operands
+  IrValue offset(IrValue base, IrValue index, int64_t scale);
+  void jump(IrBlockId);
+  void branch(IrValue, IrBlockId ifTrue, IrBlockId ifFalse);
+  // following code goes to a block no edge leads to yet
+  void startDead();
+
+  IrModule* module = nullptr;
+  IrFunction* fn = nullptr;
+  IrBlockId block = 0;
+
+  // result of the last visited expression
+  IrValue value = 0;
+  bool isAddress = false;
+
+  // address of each variable used in the function, defined in the entry block
+  std::unordered_map<Symbol*, IrValue> storage;
+  // continue and break targets of the enclosing loops
+  std::vector<std::pair<IrBlockId, IrBlockId>> loops;
+};
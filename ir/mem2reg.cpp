@@ -0,0 +1,491 @@
+#include "mem2reg.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+const uint32_t none = UINT32_MAX;
+
+struct Variable {
+  // instructions giving the address of the storage
+  std::vector<IrValue> addresses;
+  IrType type = IrType::Void;
+  bool promote = true;
+  // parameters and globals hold a value on entry
+  bool loadFirst = false;
+  // the result and globals are read after the return
+  bool storeBack = false;
+};
+
+class Promoter {
+ public:
+  Promoter(IrFunction& fn, const std::unordered_set<Atom>& escaped,
+           const std::unordered_map<Atom, uint64_t>& globalSize)
+    : fn(fn), escaped(escaped), globalSize(globalSize) {}
+
+  void run();
+
+ private:
+  void findVariables();
+  void computeDominators();
+  void placePhis();
+  void rename();
+  void removePhis();
+
+  IrValue resolve(IrValue v) const;
+  uint32_t variableOf(IrValue address) const;
+
+  IrFunction& fn;
+  const std::unordered_set<Atom>& escaped;
+  const std::unordered_map<Atom, uint64_t>& globalSize;
+
+  std::vector<Variable> vars;
+  // variable of an address or of a phi the pass placed
+  std::unordered_map<IrValue, uint32_t> owner;
+  IrValue firstNew = 0;
+  std::vector<IrValue> replaced;
+
+  std::vector<IrBlockId> idom;
+  std::vector<std::vector<IrBlockId>> frontier;
+  std::vector<std::vector<IrBlockId>> children;
+};
+
+uint32_t Promoter::variableOf(IrValue address) const {
+  auto it = owner.find(address);
+  if (it == owner.end() || address >= firstNew || !vars[it->second].promote) {
+    return none;
+  }
+  return it->second;
+}
+
+IrValue Promoter::resolve(IrValue v) const {
+  while (v < replaced.size() && replaced[v] != none) {
+    v = replaced[v];
+  }
+  return v;
+}
+
+void Promoter::run() {
+  firstNew = static_cast<IrValue>(fn.instrs.size());
+  findVariables();
+  if (std::none_of(vars.begin(), vars.end(), [](const Variable& v) { return v.promote; })) {
+    return;
+  }
+  computeDominators();
+  placePhis();
+  rename();
+  removePhis();
+}
+
+void Promoter::findVariables() {
+  bool calls = false;
+  std::unordered_map<uint64_t, uint32_t> byStorage;
+  for (auto& block : fn.blocks) {
+    for (auto v : block.instrs) {
+      auto& i = fn.get(v);
+      calls = calls || i.op == IrOp::Call;
+      uint64_t key;
+      switch (i.op) {
+        case IrOp::Local:
+        case IrOp::Param:
+          key = static_cast<uint64_t>(i.imm);
+          break;
+        case IrOp::Result:
+          key = 0;
+          break;
+        case IrOp::Global:
+          key = i.name.getId();
+          break;
+        default:
+          continue;
+      }
+      key |= static_cast<uint64_t>(i.op) << 32;
+      auto it = byStorage.find(key);
+      if (it == byStorage.end()) {
+        it = byStorage.emplace(key, static_cast<uint32_t>(vars.size())).first;
+        vars.emplace_back();
+      }
+      vars[it->second].addresses.push_back(v);
+      owner[v] = it->second;
+    }
+  }
+
+  for (auto& var : vars) {
+    auto& i = fn.get(var.addresses.front());
+    switch (i.op) {
+      case IrOp::Local:
+        var.promote = fn.slots[i.imm] <= 8;
+        break;
+      case IrOp::Param:
+        var.promote = fn.params[i.imm] <= 8;
+        var.loadFirst = true;
+        break;
+      case IrOp::Result:
+        var.promote = fn.resultSize <= 8;
+        var.storeBack = true;
+        break;
+      default: {
+        // a callee may read or write the global
+        auto size = globalSize.find(i.name);
+        var.promote = !calls && !escaped.count(i.name) && size != globalSize.end() && size->second <= 8;
+        var.loadFirst = true;
+        var.storeBack = true;
+      }
+    }
+  }
+
+  // only the address operand of loads and stores of one type
+  for (auto& block : fn.blocks) {
+    for (auto v : block.instrs) {
+      auto& i = fn.get(v);
+      for (std::size_t k = 0; k < i.args.size(); ++k) {
+        auto it = owner.find(i.args[k]);
+        if (it == owner.end()) {
+          continue;
+        }
+        auto& var = vars[it->second];
+        IrType type = IrType::Void;
+        if (k == 0 && i.op == IrOp::Load) {
+          type = i.type;
+        } else if (k == 0 && i.op == IrOp::Store) {
+          type = fn.get(i.args[1]).type;
+        }
+        if (type == IrType::Void || (var.type != IrType::Void && var.type != type)) {
+          var.promote = false;
+        }
+        var.type = type;
+      }
+    }
+  }
+  for (auto& var : vars) {
+    var.promote = var.promote && var.type != IrType::Void;
+  }
+}
+
+void Promoter::computeDominators() {
+  // Cooper, Harvey, Kennedy over the reverse postorder
+  auto blocks = fn.blocks.size();
+  std::vector<IrBlockId> order;
+  std::vector<uint32_t> number(blocks, none);
+  std::vector<std::pair<IrBlockId, std::size_t>> stack{{0, 0}};
+  std::vector<bool> seen(blocks, false);
+  seen[0] = true;
+  while (!stack.empty()) {
+    auto& [b, next] = stack.back();
+    if (next < fn.blocks[b].succs.size()) {
+      auto s = fn.blocks[b].succs[next++];
+      if (!seen[s]) {
+        seen[s] = true;
+        stack.push_back({s, 0});
+      }
+      continue;
+    }
+    order.push_back(b);
+    stack.pop_back();
+  }
+  std::reverse(order.begin(), order.end());
+  for (uint32_t k = 0; k < order.size(); ++k) {
+    number[order[k]] = k;
+  }
+
+  idom.assign(blocks, none);
+  idom[0] = 0;
+  auto intersect = [&](IrBlockId a, IrBlockId b) {
+    while (a != b) {
+      while (number[a] > number[b]) {
+        a = idom[a];
+      }
+      while (number[b] > number[a]) {
+        b = idom[b];
+      }
+    }
+    return a;
+  };
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (auto b : order) {
+      if (b == 0) {
+        continue;
+      }
+      IrBlockId dom = none;
+      for (auto p : fn.blocks[b].preds) {
+        if (idom[p] != none) {
+          dom = dom == none ? p : intersect(p, dom);
+        }
+      }
+      if (idom[b] != dom) {
+        idom[b] = dom;
+        changed = true;
+      }
+    }
+  }
+
+  frontier.assign(blocks, {});
+  children.assign(blocks, {});
+  for (IrBlockId b = 0; b < blocks; ++b) {
+    if (b != 0) {
+      children[idom[b]].push_back(b);
+    }
+    auto& preds = fn.blocks[b].preds;
+    if (preds.size() < 2) {
+      continue;
+    }
+    for (auto p : preds) {
+      for (auto runner = p; runner != idom[b]; runner = idom[runner]) {
+        auto& f = frontier[runner];
+        if (std::find(f.begin(), f.end(), b) == f.end()) {
+          f.push_back(b);
+        }
+      }
+    }
+  }
+}
+
+void Promoter::placePhis() {
+  std::vector<std::vector<IrBlockId>> stores(vars.size());
+  for (IrBlockId b = 0; b < fn.blocks.size(); ++b) {
+    for (auto v : fn.blocks[b].instrs) {
+      auto& i = fn.get(v);
+      if (i.op == IrOp::Store) {
+        auto var = variableOf(i.args[0]);
+        if (var != none && (stores[var].empty() || stores[var].back() != b)) {
+          stores[var].push_back(b);
+        }
+      }
+    }
+  }
+
+  std::vector<bool> hasPhi;
+  for (uint32_t var = 0; var < vars.size(); ++var) {
+    if (!vars[var].promote) {
+      continue;
+    }
+    vars[var].storeBack = vars[var].storeBack && !stores[var].empty();
+    hasPhi.assign(fn.blocks.size(), false);
+    auto work = stores[var];
+    while (!work.empty()) {
+      auto b = work.back();
+      work.pop_back();
+      for (auto f : frontier[b]) {
+        if (hasPhi[f]) {
+          continue;
+        }
+        hasPhi[f] = true;
+        IrInstr phi{IrOp::Phi, vars[var].type};
+        phi.from = fn.blocks[f].preds;
+        phi.args.assign(phi.from.size(), 0);
+        owner[fn.prepend(f, phi)] = var;
+        work.push_back(f);
+      }
+    }
+  }
+}
+
+void Promoter::rename() {
+  replaced.assign(fn.instrs.size(), none);
+  std::vector<std::vector<IrValue>> current(vars.size());
+
+  // the value on entry
+  for (uint32_t var = 0; var < vars.size(); ++var) {
+    auto& v = vars[var];
+    if (!v.promote) {
+      continue;
+    }
+    IrValue value;
+    if (v.loadFirst) {
+      auto& entry = fn.blocks[0].instrs;
+      auto pos = std::find(entry.begin(), entry.end(), v.addresses.front());
+      IrInstr load{IrOp::Load, v.type};
+      load.args = {v.addresses.front()};
+      value = pos == entry.end() ? fn.prepend(0, load) : fn.insert(0, pos - entry.begin() + 1, load);
+    } else {
+      // never written before it is read
+      IrInstr undefined{v.type == IrType::Double ? IrOp::ConstDouble : IrOp::Const, v.type};
+      value = fn.prepend(0, undefined);
+    }
+    current[var].push_back(value);
+  }
+
+  // preorder of the dominator tree, a value stays current in the blocks the store dominates
+  std::vector<uint32_t> log;
+  std::vector<std::pair<IrBlockId, std::size_t>> stack{{0, none}};
+  while (!stack.empty()) {
+    auto [b, mark] = stack.back();
+    stack.pop_back();
+    if (mark != none) {
+      while (log.size() > mark) {
+        current[log.back()].pop_back();
+        log.pop_back();
+      }
+      continue;
+    }
+    stack.push_back({b, log.size()});
+
+    std::vector<IrValue> kept;
+    bool isReturn = false;
+    for (auto v : fn.blocks[b].instrs) {
+      auto& i = fn.get(v);
+      if (v >= firstNew) {
+        // a placed phi or the load of the value on entry
+        if (i.op == IrOp::Phi) {
+          current[owner[v]].push_back(v);
+          log.push_back(owner[v]);
+        }
+      } else if (i.op == IrOp::Load && variableOf(i.args[0]) != none) {
+        replaced[v] = current[variableOf(i.args[0])].back();
+        continue;
+      } else if (i.op == IrOp::Store && variableOf(i.args[0]) != none) {
+        auto var = variableOf(i.args[0]);
+        current[var].push_back(resolve(i.args[1]));
+        log.push_back(var);
+        continue;
+      }
+      isReturn = i.op == IrOp::Return;
+      kept.push_back(v);
+    }
+    fn.blocks[b].instrs = std::move(kept);
+
+    if (isReturn) {
+      for (uint32_t var = 0; var < vars.size(); ++var) {
+        if (vars[var].promote && vars[var].storeBack) {
+          IrInstr store{IrOp::Store, IrType::Void};
+          store.args = {vars[var].addresses.front(), current[var].back()};
+          fn.insert(b, fn.blocks[b].instrs.size() - 1, store);
+        }
+      }
+    }
+    for (auto s : fn.blocks[b].succs) {
+      for (auto v : fn.blocks[s].instrs) {
+        auto& phi = fn.get(v);
+        if (phi.op != IrOp::Phi) {
+          break;
+        }
+        if (v < firstNew) {
+          continue;
+        }
+        for (std::size_t k = 0; k < phi.from.size(); ++k) {
+          if (phi.from[k] == b) {
+            phi.args[k] = current[owner[v]].back();
+          }
+        }
+      }
+    }
+    for (auto c : children[b]) {
+      stack.push_back({c, none});
+    }
+  }
+  replaced.resize(fn.instrs.size(), none);
+}
+
+void Promoter::removePhis() {
+  std::vector<IrValue> phis;
+  for (auto& block : fn.blocks) {
+    for (auto v : block.instrs) {
+      if (fn.get(v).op == IrOp::Phi && v >= firstNew) {
+        phis.push_back(v);
+      }
+    }
+  }
+
+  // a phi of one value besides itself is that value
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (auto phi : phis) {
+      if (replaced[phi] != none) {
+        continue;
+      }
+      IrValue same = none;
+      bool trivial = true;
+      for (auto a : fn.get(phi).args) {
+        a = resolve(a);
+        if (a == phi || a == same) {
+          continue;
+        }
+        if (same != none) {
+          trivial = false;
+          break;
+        }
+        same = a;
+      }
+      if (trivial && same != none) {
+        replaced[phi] = same;
+        changed = true;
+      }
+    }
+  }
+
+  // a placed phi or load is kept if an instruction uses it
+  std::vector<bool> used(fn.instrs.size(), false);
+  std::vector<IrValue> work;
+  for (auto& block : fn.blocks) {
+    for (auto v : block.instrs) {
+      auto& i = fn.get(v);
+      for (auto& a : i.args) {
+        a = resolve(a);
+      }
+      if (i.op == IrOp::Phi && v >= firstNew) {
+        continue;
+      }
+      for (auto a : i.args) {
+        if (!used[a]) {
+          used[a] = true;
+          work.push_back(a);
+        }
+      }
+    }
+  }
+  while (!work.empty()) {
+    auto v = work.back();
+    work.pop_back();
+    if (v < firstNew || fn.get(v).op != IrOp::Phi) {
+      continue;
+    }
+    for (auto a : fn.get(v).args) {
+      if (!used[a]) {
+        used[a] = true;
+        work.push_back(a);
+      }
+    }
+  }
+  for (auto& block : fn.blocks) {
+    auto& list = block.instrs;
+    list.erase(std::remove_if(list.begin(), list.end(), [&](IrValue v) {
+      if (v < firstNew) {
+        return false;
+      }
+      auto op = fn.get(v).op;
+      return (op == IrOp::Phi && replaced[v] != none) || ((op == IrOp::Phi || op == IrOp::Load) && !used[v]);
+    }), list.end());
+  }
+}
+
+} // namespace
+
+void promoteVariables(IrModule& m) {
+  std::unordered_map<Atom, uint64_t> globalSize;
+  for (auto& g : m.globals) {
+    globalSize[g.name] = g.size;
+  }
+  // a global whose address is an operand of anything but a load or a store
+  std::unordered_set<Atom> escaped;
+  for (auto& fn : m.functions) {
+    for (auto& block : fn.blocks) {
+      for (auto v : block.instrs) {
+        auto& i = fn.get(v);
+        for (std::size_t k = 0; k < i.args.size(); ++k) {
+          auto& a = fn.get(i.args[k]);
+          if (a.op == IrOp::Global && !(k == 0 && (i.op == IrOp::Load || i.op == IrOp::Store))) {
+            escaped.insert(a.name);
+          }
+        }
+      }
+    }
+  }
+
+  for (auto& fn : m.functions) {
+    Promoter(fn, escaped, globalSize).run();
+    fn.verify();
+  }
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "ir.h"
+
+// Turns the scalar variables a function only loads and stores into SSA
+// values: locals, parameters and the result, and the globals whose address
+// is taken nowhere in the program when the function calls nothing. Loads
+// take the reaching value, stores vanish and phis join the values where
+// control flow meets. A global or the result is stored back before return.
+void promoteVariables(IrModule&);
@@ -2,21 +2,30 @@
 #include <memory>
 #include <fstream>
 #include <algorithm>
+#include <chrono>
+#include <sys/resource.h>
 
 #include "cxxopts.hpp"
 
 #include "lexer.h"
+#include "parallel_lexer.h"
 #include "exception.h"
 #include "parser.h"
 #include "visitor.h"
 #include "type_checker.h"
 #include "generator.h"
+#include "ir_builder.h"
+#include "mem2reg.h"
+#include "ir_lowering.h"
+#include "peephole.h"
+#include "arena.h"
+#include "type_table.h"
 
 
-void lexerTest(const std::string& inputFileName,const std::string& outputFileName) {
+void lexerTest(const std::string& inputFileName,const std::string& outputFileName, lx::SourceMode mode) {
   std::ofstream out;
   out.open(outputFileName, std::ifstream::out);
-  lx::Lexer lex(inputFileName);
+  lx::Lexer lex(inputFileName, mode);
   try {
     for (auto token = lex.next(); !token.is(TokenType::EndOfFile); token = lex.next()) {
       out << token.getTestLine() << std::endl;
@@ -27,8 +36,46 @@ void lexerTest(const std::string& inputFileName,const std::string& outputFileNam
   out.close();
 }
 
-void parserExpressionTest(const std::string& inputFileName, const std::string& outputFileName) {
-  Parser p(inputFileName);
+void lexerParallelTest(const std::string& inputFileName, const std::string& outputFileName, unsigned jobs) {
+  std::ofstream out;
+  out.open(outputFileName, std::ifstream::out);
+  lx::ParallelLexer lex(inputFileName, jobs);
+  try {
+    lex.forEachToken([&out](const Token& token) {
+      out << token.getTestLine() << std::endl;
+    });
+    lex.checkError();
+  } catch(LexerException& e) {
+    out << e.what() << std::endl;
+  }
+  out.close();
+}
+
+void lexerBench(const std::string& inputFileName, lx::SourceMode mode, unsigned jobs) {
+  auto start = std::chrono::steady_clock::now();
+  uint64_t count = 0;
+  try {
+    if (jobs > 1) {
+      lx::ParallelLexer lex(inputFileName, jobs);
+      count = lex.getNumToken();
+      lex.checkError();
+    } else {
+      lx::Lexer lex(inputFileName, mode);
+      for (auto token = lex.next(); !token.is(TokenType::EndOfFile); token = lex.next()) {
+        ++count;
+      }
+    }
+  } catch(LexerException& e) {
+    std::cout << e.what() << std::endl;
+  }
+  std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+  std::cout << "tokens: " << count
+            << "\ttime: " << time.count() << " s"
+            << "\ttokens/s: " << static_cast<uint64_t>(count / time.count()) << std::endl;
+}
+
+void parserExpressionTest(const std::string& inputFileName, const std::string& outputFileName, lx::SourceMode mode) {
+  Parser p(inputFileName, mode);
   PrintVisitor v(outputFileName);
   try {
     auto tree = p.parseExpression();
@@ -39,8 +86,8 @@ void parserExpressionTest(const std::string& inputFileName, const std::string& o
   }
 }
 
-void parserProgramTest(const std::string& inputFileName, const std::string& outputFileName) {
-  Parser p(inputFileName);
+void parserProgramTest(const std::string& inputFileName, const std::string& outputFileName, lx::SourceMode mode) {
+  Parser p(inputFileName, mode);
   PrintVisitor v(outputFileName);
   try {
     auto tree = p.parseProgram();
@@ -51,11 +98,129 @@ void parserProgramTest(const std::string& inputFileName, const std::string& outp
   }
 }
 
-void createAsm(const std::string& inputFileName, const std::string& outputFileName) {
-  Parser p(inputFileName);
-  AsmGenerator g(outputFileName);
+void parserBench(const std::string& inputFileName, lx::SourceMode mode, bool isExpression) {
+  const int numWalk = 10;
+  try {
+    auto start = std::chrono::steady_clock::now();
+    Parser p(inputFileName, mode);
+    ptr_Node tree = isExpression ? p.parseExpression() : p.parseProgram();
+    std::chrono::duration<double> parse = std::chrono::steady_clock::now() - start;
+
+    CountVisitor v;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numWalk; ++i) {
+      tree->accept(v);
+    }
+    std::chrono::duration<double> walk = std::chrono::steady_clock::now() - start;
+
+    // the same walk with the children reached through dispatch()
+    DispatchCountVisitor d;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numWalk; ++i) {
+      tree->accept(d);
+    }
+    std::chrono::duration<double> dispatchWalk = std::chrono::steady_clock::now() - start;
+
+    // the type predicates on the type of every expression
+    std::vector<ptr_Type> types;
+    CountVisitor collect(&types);
+    tree->accept(collect);
+    uint64_t numTrue = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numWalk; ++i) {
+      for (auto t : types) {
+        numTrue += t->isVoid() + t->isString() + t->isInt() + t->isDouble() +
+                   t->isBool() + t->isChar() + t->isPurePointer() + t->isTypePointer() +
+                   t->isProcedureType() + t->isOpenArray() + t->isStaticArray();
+      }
+    }
+    std::chrono::duration<double> predicate = std::chrono::steady_clock::now() - start;
+    auto numPredicate = std::max<uint64_t>(1, types.size() * numWalk * 11);
+
+    std::cout << "nodes: " << v.getNumNode() / numWalk
+              << "\tparse: " << parse.count() << " s"
+              << "\ttraversal: " << walk.count() / numWalk << " s"
+              << "\tnodes/s: " << static_cast<uint64_t>(v.getNumNode() / walk.count()) << std::endl
+              << "visit accept: " << walk.count() * 1e9 / v.getNumNode() << " ns/node"
+              << "\tdispatch: " << dispatchWalk.count() * 1e9 / d.getNumNode() << " ns/node" << std::endl
+              << "type predicates: " << predicate.count() * 1e9 / numPredicate << " ns/call"
+              << "\ttrue: " << numTrue / numWalk << std::endl;
+  } catch(CompilerException& e) {
+    std::cout << e.what() << std::endl;
+  }
+}
+
+enum class Backend {
+  Stack,
+  Ir,
+  DumpIr,
+};
+
+struct AsmOptions {
+  Backend backend = Backend::Stack;
+  // 1 runs the peephole pass
+  unsigned level = 0;
+  bool isComments = true;
+  bool isStats = false;
+};
+
+void createAsm(const std::string& inputFileName, const std::string& outputFileName, lx::SourceMode mode,
+               const AsmOptions& options) {
+  Parser p(inputFileName, mode);
   auto tree = p.parseProgram();
-  tree->accept(g);
+  Peephole peephole;
+  auto setUp = [&](AsmListing& listing) {
+    listing.setComments(options.isComments);
+    if (options.level >= 1) {
+      listing.setPass([&peephole](std::vector<Command>& c) { peephole.run(c); });
+    }
+  };
+  if (options.backend == Backend::Stack) {
+    AsmGenerator g(outputFileName);
+    setUp(g.asm_file);
+    tree->accept(g);
+    g.asm_file.flush();
+  } else {
+    auto module = IrBuilder().build(static_cast<MainFunction&>(*tree));
+    promoteVariables(module);
+    if (options.backend == Backend::DumpIr) {
+      std::ofstream out(outputFileName);
+      module.print(out);
+      return;
+    }
+    IrLowering lowering(outputFileName);
+    setUp(lowering.asm_file);
+    lowering.lower(module);
+    lowering.asm_file.flush();
+  }
+  if (options.level >= 1 && options.isStats) {
+    peephole.report(std::cout);
+  }
+}
+
+// Runs one compilation stage with its own arena and type table, all nodes are released together at the end.
+template <class F>
+void compile(bool isStats, F stage) {
+  Arena arena;
+  {
+    Arena::Scope scope(arena);
+    TypeTable types;
+    TypeTable::Scope typeScope(types);
+    stage();
+  }
+  auto numObject = arena.getNumObject();
+  auto numByte = arena.getNumByte();
+  auto start = std::chrono::steady_clock::now();
+  arena.release();
+  std::chrono::duration<double> teardown = std::chrono::steady_clock::now() - start;
+  if (isStats) {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << "nodes: " << numObject
+              << "\tarena: " << numByte / 1024 << " KB"
+              << "\tpeak RSS: " << usage.ru_maxrss << " KB"
+              << "\tteardown: " << teardown.count() << " s" << std::endl;
+  }
 }
 
 void parseCommandArgs(int args, char* argv[]);
@@ -68,6 +233,8 @@ void parseCommandArgs(int args, char* argv[]) {
 	cxxopts::Options options(argv[0]);
 
 	std::string input, output;
+	unsigned jobs = 1;
+	unsigned level = 0;
 
 	options
 		.add_options()
@@ -76,7 +243,15 @@ void parseCommandArgs(int args, char* argv[]) {
       ("l,lexer", "Generate a stream of tokens", cxxopts::value<bool>())
       ("e,expression", "Build Ast-tree simple pascal expression", cxxopts::value<bool>())
       ("p,parser", "Build Ast-tree pascal program", cxxopts::value<bool>())
-      ("a,assembler", "Create .asm file", cxxopts::value<bool>());
+      ("a,assembler", "Create .asm file", cxxopts::value<bool>())
+      ("s,stream", "Read source through std::ifstream instead of in-memory buffer", cxxopts::value<bool>())
+      ("j,jobs", "Lex in parallel chunks on N threads, in-memory buffer only", cxxopts::value<unsigned>(jobs))
+      ("b,bench", "Report throughput of the selected stage instead of writing output", cxxopts::value<bool>())
+      ("stats", "Report node count, peak RSS and teardown time of the ast", cxxopts::value<bool>())
+      ("ir-backend", "Generate assembler through the IR instead of with the stack machine generator", cxxopts::value<bool>())
+      ("ir", "With -a write the IR of the program instead of assembler", cxxopts::value<bool>())
+      ("O,optimize", "Optimization level of the assembler, 1 runs the peephole pass", cxxopts::value<unsigned>(level))
+      ("no-comments", "Leave the comments out of the assembler", cxxopts::value<bool>());
 
 	try {
     auto result = options.parse(args, argv);
@@ -101,20 +276,48 @@ void parseCommandArgs(int args, char* argv[]) {
       }
     }
 
+    auto mode = result.count("s") ? lx::SourceMode::Stream : lx::SourceMode::Buffer;
+
+    auto bench = result.count("b") > 0;
+    auto stats = result.count("stats") > 0;
+
+    if (mode == lx::SourceMode::Stream) {
+      jobs = 1;
+    }
+
     if (result.count("l")) {
-      lexerTest(input, output);
+      if (bench) {
+        lexerBench(input, mode, jobs);
+      } else if (jobs > 1) {
+        lexerParallelTest(input, output, jobs);
+      } else {
+        lexerTest(input, output, mode);
+      }
     }
 
     if (result.count("e")) {
-      parserExpressionTest(input, output);
+      if (bench) {
+        compile(stats, [&] { parserBench(input, mode, true); });
+      } else {
+        compile(stats, [&] { parserExpressionTest(input, output, mode); });
+      }
     }
 
     if (result.count("p")) {
-      parserProgramTest(input, output);
+      if (bench) {
+        compile(stats, [&] { parserBench(input, mode, false); });
+      } else {
+        compile(stats, [&] { parserProgramTest(input, output, mode); });
+      }
     }
 
     if (result.count("a")) {
-      createAsm(input, output);
+      AsmOptions asmOptions;
+      asmOptions.backend = result.count("ir") ? Backend::DumpIr : result.count("ir-backend") ? Backend::Ir : Backend::Stack;
+      asmOptions.level = level;
+      asmOptions.isComments = result.count("no-comments") == 0;
+      asmOptions.isStats = stats;
+      compile(stats, [&] { createAsm(input, output, mode, asmOptions); });
     }
 
   } catch (const cxxopts::OptionException& e) {
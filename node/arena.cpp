@@ -0,0 +1,68 @@
+#include "arena.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+thread_local Arena* currentArena = nullptr;
+}
+
+Arena::~Arena() { release(); }
+
+Arena& Arena::current() {
+  if (currentArena == nullptr) {
+    throw std::logic_error("No arena for a new node");
+  }
+  return *currentArena;
+}
+
+Arena::Scope::Scope(Arena& a)
+  : previous(currentArena) {
+  currentArena = &a;
+}
+
+Arena::Scope::~Scope() { currentArena = previous; }
+
+void* Arena::allocate(std::size_t size, std::size_t align) {
+  auto p = reinterpret_cast<std::uintptr_t>(cursor);
+  auto aligned = (p + align - 1) & ~(align - 1);
+  if (cursor == nullptr || aligned + size > reinterpret_cast<std::uintptr_t>(limit)) {
+    if (size + align > blockSize) {
+      // keeps the current block for the small objects that follow
+      numByte += size;
+      return allocateBlock(size);
+    }
+    cursor = static_cast<char*>(allocateBlock(blockSize));
+    limit = cursor + blockSize;
+    p = reinterpret_cast<std::uintptr_t>(cursor);
+    aligned = (p + align - 1) & ~(align - 1);
+  }
+  cursor = reinterpret_cast<char*>(aligned + size);
+  numByte += size;
+  return reinterpret_cast<void*>(aligned);
+}
+
+void* Arena::allocateBlock(std::size_t size) {
+  blocks.reserve(blocks.size() + 1);
+  void* b = std::malloc(size);
+  if (b == nullptr) {
+    throw std::bad_alloc();
+  }
+  blocks.push_back(b);
+  return b;
+}
+
+void Arena::release() {
+  for (auto c = cleanups; c != nullptr; c = c->next) {
+    c->destroy(c->object);
+  }
+  cleanups = nullptr;
+  for (auto b : blocks) {
+    std::free(b);
+  }
+  blocks.clear();
+  cursor = limit = nullptr;
+  numObject = 0;
+  numByte = 0;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Owns every ASTNode, Symbol and SymType of one compilation. Objects are
+// bump allocated from large blocks and referenced by plain pointers, the
+// whole arena is released at once. Only types that own memory of their
+// own (lists, tables, strings) leave a destructor to run on release.
+class Arena {
+ public:
+  Arena() = default;
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+  ~Arena();
+
+  template <class T, class... Args>
+  T* make(Args&&... args);
+
+  void release();
+
+  std::size_t getNumObject() const { return numObject; }
+  std::size_t getNumByte() const { return numByte; }
+
+  static Arena& current();
+
+  // makes an arena current for makeNode on this thread
+  class Scope {
+   public:
+    explicit Scope(Arena& a);
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope();
+
+   private:
+    Arena* previous;
+  };
+
+ private:
+  struct Cleanup {
+    void (*destroy)(void*);
+    void* object;
+    Cleanup* next;
+  };
+
+  static constexpr std::size_t blockSize = 64 * 1024;
+
+  void* allocate(std::size_t size, std::size_t align);
+  void* allocateBlock(std::size_t size);
+
+  std::vector<void*> blocks;
+  char* cursor = nullptr;
+  char* limit = nullptr;
+  Cleanup* cleanups = nullptr;
+  std::size_t numObject = 0;
+  std::size_t numByte = 0;
+};
+
+template <class T, class... Args>
+T* Arena::make(Args&&... args) {
+  void* p = allocate(sizeof(T), alignof(T));
+  T* object = new (p) T(std::forward<Args>(args)...);
+  if constexpr (!std::is_trivially_destructible_v<T>) {
+    auto c = static_cast<Cleanup*>(allocate(sizeof(Cleanup), alignof(Cleanup)));
+    c->destroy = [](void* o) { static_cast<T*>(o)->~T(); };
+    c->object = object;
+    c->next = cleanups;
+    cleanups = c;
+  }
+  ++numObject;
+  return object;
+}
+
+template <class T, class... Args>
+T* makeNode(Args&&... args) {
+  return Arena::current().make<T>(std::forward<Args>(args)...);
+}
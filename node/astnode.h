@@ -1,9 +1,10 @@
 #pragma once
 
-#include <memory>
-#include <list>
+#include <cstdint>
 
 #include "token.h"
+#include "small_vector.h"
+#include "arena.h"
 
 class ASTNode;
 class Expression;
@@ -21,35 +22,101 @@ class Const;
 
 class Tables;
 
-using ptr_Node = std::shared_ptr<ASTNode>;
-using ptr_Symbol = std::shared_ptr<Symbol>;
-using ptr_Var = std::shared_ptr<SymVar>;
-using ptr_Type = std::shared_ptr<SymType>;
-using ptr_Fun = std::shared_ptr<SymFun>;
-using ptr_Sign = std::shared_ptr<FunctionSignature>;
-using ptr_Const = std::shared_ptr<Const>;
+// nodes and symbols live in the compilation Arena, the tree only refers to them
+using ptr_Node = ASTNode*;
+using ptr_Symbol = Symbol*;
+using ptr_Var = SymVar*;
+using ptr_Type = SymType*;
+using ptr_Fun = SymFun*;
+using ptr_Sign = FunctionSignature*;
+using ptr_Const = Const*;
+using ptr_Param = ParamVar*;
 
-using ptr_Expr = std::unique_ptr<Expression>;
-using ptr_Stmt = std::unique_ptr<ASTNodeStmt>;
+using ptr_Expr = Expression*;
+using ptr_Stmt = ASTNodeStmt*;
 
-using ListExpr = std::list<ptr_Expr>;
-using ListStmt = std::list<ptr_Stmt>;
-using ListParam = std::list<std::shared_ptr<ParamVar>>;
+using ListExpr = lx::SmallVector<ptr_Expr, 4>;
+using ListStmt = lx::SmallVector<ptr_Stmt, 4>;
+using ListParam = lx::SmallVector<ptr_Param, 4>;
 
 class Visitor;
 
+// concrete class of a node or symbol, lets a pass switch on it instead of
+// going through accept() and a virtual visit
+enum class NodeKind : uint8_t {
+  Variable,
+  Literal,
+  BinaryOperation,
+  UnaryOperation,
+  ArrayAccess,
+  RecordAccess,
+  FunctionCall,
+  Cast,
+
+  AssignmentStmt,
+  FunctionCallStmt,
+  BlockStmt,
+  IfStmt,
+  WhileStmt,
+  ForStmt,
+  BreakStmt,
+  ContinueStmt,
+
+  Int,
+  Double,
+  Char,
+  Boolean,
+  TPointer,
+  String,
+  Void,
+  Alias,
+  ForwardType,
+  Pointer,
+  StaticArray,
+  OpenArray,
+  Record,
+  FunctionSignature,
+
+  LocalVar,
+  GlobalVar,
+  ParamVar,
+  Const,
+
+  ForwardFunction,
+  Function,
+  MainFunction,
+  Read,
+  Write,
+  Trunc,
+  Round,
+  Succ,
+  Prev,
+  Chr,
+  Ord,
+  High,
+  Low,
+  Exit
+};
+
 class ASTNode {
  public:
   ASTNode();
   ASTNode(int line, int column);
   ASTNode(const Token& t);
-  virtual ~ASTNode() = default;
 
   virtual void accept(Visitor&) = 0;
   void setDeclPoint(const Token& t);
   int getDeclLine();
   int getDeclColumn();
   auto& getDeclPoint() { return declPoint; }
+  NodeKind getKind() const { return kind; }
+
+ protected:
+  // released by the Arena, never deleted through a base pointer
+  ~ASTNode() = default;
+
+  // set by the constructor of every concrete class
+  NodeKind kind;
 
  private:
   Token declPoint;
@@ -58,19 +125,21 @@ class ASTNode {
 class Symbol : public ASTNode {
  public:
   using ASTNode::ASTNode;
-  Symbol(const Token&, const std::string&);
+  Symbol(const Token&, Atom);
   Symbol(const std::string& n);
+  Symbol(Atom n);
   Symbol(const Token& t);
 
   // todo how remove
   virtual bool isForward() const;
-  bool isAnonymous() const { return name.empty(); }
+  bool isAnonymous() const { return name == Atom(); }
 
-  const std::string& getSymbolName() const { return name; }
-  void setSymbolName(std::string n) { name = std::move(n); }
+  Atom getAtom() const { return name; }
+  const std::string& getSymbolName() const { return name.str(); }
+  void setSymbolName(Atom n) { name = n; }
 
  private:
-  std::string name;
+  Atom name;
 };
 
 class SymFun : public Symbol {
@@ -91,7 +160,7 @@ class SymFun : public Symbol {
 	virtual Tables& getTable() {throw std::logic_error("get Table"); };
 
  protected:
-  ptr_Sign signature;
+  ptr_Sign signature = nullptr;
   std::string label;
 };
 
@@ -100,7 +169,7 @@ class SymVar : public Symbol {
   //using Symbol::Symbol;
   SymVar(ptr_Type t);
 
-  SymVar(std::string name, ptr_Type t);
+  SymVar(Atom name, ptr_Type t);
   SymVar(const Token& n, ptr_Type t);
 
     // todo remove
@@ -111,5 +180,5 @@ class SymVar : public Symbol {
   auto& getVarType() { return type; }
 
  protected:
-	ptr_Type type;
+	ptr_Type type = nullptr;
 };
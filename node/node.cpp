@@ -2,10 +2,10 @@
 #include "visitor.h"
 
 ASTNode::ASTNode()
-	: declPoint(-1, -1, TokenType::Non) {}
+	: declPoint({}, TokenType::Non) {}
 
 ASTNode::ASTNode(int line, int column)
-	: declPoint(line, column, TokenType::Non) {}
+	: declPoint(SourcePoint(line, column), TokenType::Non) {}
 
 ASTNode::ASTNode(const Token& t)
 	: declPoint(t) {}
@@ -21,72 +21,108 @@ Expression::Expression(ptr_Type t)
   : type(std::move(t)) {}
 
 Variable::Variable(const Token& n)
-  : ASTNode(n), name(n) {}
+  : ASTNode(n), name(n) {
+  kind = NodeKind::Variable;
+}
 
 Variable::Variable(const Token& n, ptr_Type t)
-  : ASTNode(n), Expression(std::move(t)), name(n) {}
+  : ASTNode(n), Expression(std::move(t)), name(n) {
+  kind = NodeKind::Variable;
+}
 
 Literal::Literal(const Token& v)
-  : ASTNode(v), value(v) {}
+  : ASTNode(v), value(v) {
+  kind = NodeKind::Literal;
+}
 
 Literal::Literal(const Token& v, ptr_Type t)
-	: ASTNode(v), Expression(std::move(t)), value(v) {};
+	: ASTNode(v), Expression(std::move(t)), value(v) {
+  kind = NodeKind::Literal;
+};
 
 BinaryOperation::BinaryOperation(const Token& op, ptr_Expr left, ptr_Expr right)
   : ASTNode(op),
-    op(op), left(std::move(left)), right(std::move(right)) {}
+    op(op), left(std::move(left)), right(std::move(right)) {
+  kind = NodeKind::BinaryOperation;
+}
 
 UnaryOperation::UnaryOperation(const Token& opr, ptr_Expr expr)
   : ASTNode(opr),
-    op(opr), expr(std::move(expr)) {}
+    op(opr), expr(std::move(expr)) {
+  kind = NodeKind::UnaryOperation;
+}
 
 ArrayAccess::ArrayAccess(const Token& d, ptr_Expr name, ListExpr i)
   : ASTNode(d),
-    nameArray(std::move(name)), listIndex(std::move(i)) {}
+    nameArray(std::move(name)), listIndex(std::move(i)) {
+  kind = NodeKind::ArrayAccess;
+}
 
 FunctionCall::FunctionCall(const Token& d, ptr_Expr nameFunction, ListExpr listParam)
   : ASTNode(d),
-    nameFunction(std::move(nameFunction)), listParam(std::move(listParam)) {}
+    nameFunction(std::move(nameFunction)), listParam(std::move(listParam)) {
+  kind = NodeKind::FunctionCall;
+}
 
 
 Cast::Cast(ptr_Type to, ptr_Expr expr)
   : Expression(std::move(to)),
-    expr(std::move(expr)) {}
+    expr(std::move(expr)) {
+  kind = NodeKind::Cast;
+}
 
  Cast::Cast(FunctionCall f)
   : ASTNode(f.getDeclPoint()),
     Expression(std::move(f.getNodeType())),
-    expr(std::move(f.getListParam().back())) {}
+    expr(std::move(f.getListParam().back())) {
+  kind = NodeKind::Cast;
+}
 
 RecordAccess::RecordAccess(const Token& d, ptr_Expr record, Token field)
   : ASTNode(d),
-    record(std::move(record)), field(std::move(field)) {}
+    record(std::move(record)), field(std::move(field)) {
+  kind = NodeKind::RecordAccess;
+}
 
 AssignmentStmt::AssignmentStmt(const Token& op, ptr_Expr left, ptr_Expr right)
 	: ASTNode(op),
-		BinaryOperation(op, std::move(left), std::move(right)) {}
+		BinaryOperation(op, std::move(left), std::move(right)) {
+  kind = NodeKind::AssignmentStmt;
+}
 
 FunctionCallStmt::FunctionCallStmt(ptr_Expr e)
-  : functionCall(std::move(e)) {}
+  : functionCall(std::move(e)) {
+  kind = NodeKind::FunctionCallStmt;
+}
 
 BlockStmt::BlockStmt(ListStmt block)
-  : stmts(std::move(block)) {}
+  : stmts(std::move(block)) {
+  kind = NodeKind::BlockStmt;
+}
 
 IfStmt::IfStmt(ptr_Expr cond, ptr_Stmt then_)
-  : condition(std::move(cond)), then_stmt(std::move(then_)) {}
+  : condition(std::move(cond)), then_stmt(std::move(then_)) {
+  kind = NodeKind::IfStmt;
+}
 
 IfStmt::IfStmt(ptr_Expr cond, ptr_Stmt then_, ptr_Stmt else_)
   : condition(std::move(cond)),
-    then_stmt(std::move(then_)) , else_stmt(std::move(else_)) {}
+    then_stmt(std::move(then_)) , else_stmt(std::move(else_)) {
+  kind = NodeKind::IfStmt;
+}
 
 WhileStmt::WhileStmt(ptr_Expr cond, ptr_Stmt block)
-  : condition(std::move(cond)), block(std::move(block)) {}
+  : condition(std::move(cond)), block(std::move(block)) {
+  kind = NodeKind::WhileStmt;
+}
 
-ForStmt::ForStmt(std::unique_ptr<Variable> v,
+ForStmt::ForStmt(Variable* v,
                  ptr_Expr l, ptr_Expr h, bool d,
                  ptr_Stmt block)
   : var(std::move(v)), block(std::move(block)),
-    low(std::move(l)), high(std::move(h)), direct(d) {}
+    low(std::move(l)), high(std::move(h)), direct(d) {
+  kind = NodeKind::ForStmt;
+}
 
 
 void Variable::accept(Visitor& v) { v.visit(*this); }
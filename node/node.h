@@ -1,8 +1,6 @@
 #pragma once
 
 #include <string>
-#include <memory>
-#include <list>
 
 #include "token.h"
 #include "astnode.h"
@@ -13,7 +11,7 @@ class Expression : public virtual ASTNode {
   Expression(ptr_Type t);
 
   // todo remove
-  virtual std::string getVarName() { return ""; }
+  virtual Atom getVarName() { return Atom(); }
 
   auto& getNodeType() { return type; }
   auto& getEmbeddedFunction() { return embeddedFunction; }
@@ -21,9 +19,9 @@ class Expression : public virtual ASTNode {
   void setEmbeddedFunction(ptr_Fun e) { embeddedFunction = std::move(e); }
 
  protected:
-  ptr_Type type;
+  ptr_Type type = nullptr;
   // todo remove this
-  ptr_Fun embeddedFunction;
+  ptr_Fun embeddedFunction = nullptr;
 };
 
 class Variable : public Expression {
@@ -33,11 +31,22 @@ class Variable : public Expression {
 
   auto& getSubToken() { return name; }
   // todo remove virtual
-  std::string getVarName() override { return name.getString(); }
+  Atom getVarName() override { return name.getAtom(); }
   void accept(Visitor&) override;
 
+  // variable or function the name resolves to, set by TypeChecker
+  ptr_Symbol getSymbol() { return symbol; }
+  uint32_t getScopeDistance() const { return scopeDistance; }
+  void setSymbol(ptr_Symbol s, uint32_t distance) {
+    symbol = s;
+    scopeDistance = distance;
+  }
+
  private:
   Token name;
+  ptr_Symbol symbol = nullptr;
+  // scopes out from the use to the declaration, 0 - the innermost scope
+  uint32_t scopeDistance = 0;
 };
 
 class Literal : public Expression {
@@ -66,8 +75,8 @@ class BinaryOperation : public Expression {
 
  private:
   Token op;
-  ptr_Expr left;
-  ptr_Expr right;
+  ptr_Expr left = nullptr;
+  ptr_Expr right = nullptr;
 };
 
 class UnaryOperation : public Expression {
@@ -80,7 +89,7 @@ class UnaryOperation : public Expression {
 
  private:
   Token op;
-  ptr_Expr expr;
+  ptr_Expr expr = nullptr;
 };
 
 class ArrayAccess : public Expression {
@@ -92,13 +101,13 @@ class ArrayAccess : public Expression {
   void accept(Visitor&) override;
 
  private:
-  ptr_Expr nameArray;
+  ptr_Expr nameArray = nullptr;
   ListExpr listIndex;
 };
 
 class FunctionCall : public Expression {
  public:
-  FunctionCall() = default;
+  FunctionCall() { kind = NodeKind::FunctionCall; }
   FunctionCall(const Token&, ptr_Expr, ListExpr);
 
   auto& getSubNode() { return nameFunction; }
@@ -108,7 +117,7 @@ class FunctionCall : public Expression {
   void accept(Visitor&) override;
 
  private:
-  ptr_Expr nameFunction;
+  ptr_Expr nameFunction = nullptr;
   ListExpr listParam;
 };
 
@@ -122,7 +131,7 @@ class Cast : public Expression {
   void accept(Visitor& v) override;
 
  private:
-  ptr_Expr expr;
+  ptr_Expr expr = nullptr;
 };
 
 class RecordAccess : public Expression {
@@ -134,7 +143,7 @@ class RecordAccess : public Expression {
   void accept(Visitor&) override;
 
  private:
-  ptr_Expr record;
+  ptr_Expr record = nullptr;
   Token field;
 };
 
@@ -154,7 +163,7 @@ class FunctionCallStmt : public ASTNodeStmt {
   void accept(Visitor&) override;
 
  private:
-  ptr_Expr functionCall;
+  ptr_Expr functionCall = nullptr;
 };
 
 class BlockStmt : public ASTNodeStmt {
@@ -181,8 +190,8 @@ class IfStmt : public ASTNodeStmt {
   void accept(Visitor&) override;
 
  private:
-  ptr_Expr condition;
-  ptr_Stmt then_stmt;
+  ptr_Expr condition = nullptr;
+  ptr_Stmt then_stmt = nullptr;
   ptr_Stmt else_stmt = nullptr;
 };
 
@@ -198,13 +207,13 @@ class WhileStmt : public LoopStmt {
   void accept(Visitor&) override;
 
  private:
-  ptr_Expr condition;
-  ptr_Stmt block;
+  ptr_Expr condition = nullptr;
+  ptr_Stmt block = nullptr;
 };
 
 class ForStmt : public LoopStmt {
  public:
-  ForStmt(std::unique_ptr<Variable>,
+  ForStmt(Variable*,
           ptr_Expr, ptr_Expr, bool,
           ptr_Stmt);
 
@@ -216,21 +225,21 @@ class ForStmt : public LoopStmt {
   void accept(Visitor&) override;
 
  private:
-	std::unique_ptr<Variable> var;
-  ptr_Stmt block;
-  ptr_Expr low;
-  ptr_Expr high;
+	Variable* var = nullptr;
+  ptr_Stmt block = nullptr;
+  ptr_Expr low = nullptr;
+  ptr_Expr high = nullptr;
   bool direct;
 };
 
 class BreakStmt : public ASTNodeStmt {
  public:
-  BreakStmt() = default;
+  BreakStmt() { kind = NodeKind::BreakStmt; }
   void accept(Visitor&) override;
 };
 
 class ContinueStmt : public ASTNodeStmt {
  public:
-  ContinueStmt() = default;
+  ContinueStmt() { kind = NodeKind::ContinueStmt; }
   void accept(Visitor&) override;
 };
@@ -1,8 +1,10 @@
+#include <algorithm>
 #include <iostream>
 #include "table_symbol.h"
 #include "symbol_type.h"
 #include "symbol_var.h"
 #include "symbol_fun.h"
+#include "type_table.h"
 
 #include "exception"
 #include "../exception.h"
@@ -10,153 +12,210 @@
 
 
 Symbol::Symbol(const std::string& n)
+  : name(intern(n)) {}
+
+Symbol::Symbol(Atom n)
   : name(n) {}
 
 Symbol::Symbol(const Token& t)
   :  ASTNode(t) {}
 
-Symbol::Symbol(const Token& t, const std::string& n)
+Symbol::Symbol(const Token& t, Atom n)
   : ASTNode(t), name(n) {}
 
 SymFun::SymFun(const Token &t, ptr_Sign f)
-  : Symbol(t, t.getString()), signature(std::move(f)) {}
+  : Symbol(t, t.getAtom()), signature(std::move(f)) {}
 
 SymVar::SymVar(ptr_Type t)
   : type(std::move(t)) {}
 
-SymVar::SymVar(std::string name, ptr_Type t)
+SymVar::SymVar(Atom name, ptr_Type t)
   : Symbol(name), type(std::move(t)) {}
 
 SymVar::SymVar(const Token& n, ptr_Type t)
-  : Symbol(n, n.getString()), type(std::move(t)) {}
+  : Symbol(n, n.getAtom()), type(std::move(t)) {}
 
 Function::Function(const Token &t, ptr_Sign f)
-  : SymFun(t, std::move(f)) {}
+  : SymFun(t, std::move(f)), localVar(makeNode<Tables>()) {
+  kind = NodeKind::Function;
+}
 
-Function::Function(const Token& t, ptr_Sign f, ptr_Stmt p, Tables l)
+Function::Function(const Token& t, ptr_Sign f, ptr_Stmt p, Tables& l)
   : SymFun(t, std::move(f)),
-      localVar(std::move(l)), body(std::move(p)) {}
-
-Function::~Function() = default;
+      localVar(&l), body(std::move(p)) {
+  kind = NodeKind::Function;
+}
 
 ForwardFunction::ForwardFunction(const Token& t, ptr_Sign f)
-  : SymFun(t, std::move(f)) {}
+  : SymFun(t, std::move(f)) {
+  kind = NodeKind::ForwardFunction;
+}
 
-MainFunction::MainFunction(Tables t, ptr_Stmt b)
-    : SymFun("Main block"), body(std::move(b)), decl(std::move(t)) {}
+MainFunction::MainFunction(Tables& t, ptr_Stmt b)
+    : SymFun("Main block"), body(std::move(b)), decl(&t) {
+  kind = NodeKind::MainFunction;
+}
 
 Round::Round() : BuildInFun("round") {
-  auto var = std::make_shared<ParamVar>(std::make_shared<Double>(), ParamSpec::NotSpec);
-  ListParam params(1, var);
-  signature = std::make_shared<FunctionSignature>(params, std::make_shared<Int>());
+  kind = NodeKind::Round;
+  auto var = makeNode<ParamVar>(makeNode<Double>(), ParamSpec::NotSpec);
+  ListParam params{var};
+  signature = makeNode<FunctionSignature>(params, makeNode<Int>());
 }
 
 Trunc::Trunc() : BuildInFun("trunc") {
-  auto var = std::make_shared<ParamVar>(std::make_shared<Double>(), ParamSpec::NotSpec);
-  ListParam params(1, var);
-  signature = std::make_shared<FunctionSignature>(params, std::make_shared<Int>());
+  kind = NodeKind::Trunc;
+  auto var = makeNode<ParamVar>(makeNode<Double>(), ParamSpec::NotSpec);
+  ListParam params{var};
+  signature = makeNode<FunctionSignature>(params, makeNode<Int>());
 };
 
 Succ::Succ() : BuildInFun("succ") {
-  auto var = std::make_shared<ParamVar>(std::make_shared<Int>(), ParamSpec::NotSpec);
-  ListParam params(1, var);
-  signature = std::make_shared<FunctionSignature>(params, std::make_shared<Int>());
+  kind = NodeKind::Succ;
+  auto var = makeNode<ParamVar>(makeNode<Int>(), ParamSpec::NotSpec);
+  ListParam params{var};
+  signature = makeNode<FunctionSignature>(params, makeNode<Int>());
 }
 
 Prev::Prev()  : BuildInFun("prev") {
-  auto var = std::make_shared<ParamVar>(std::make_shared<Int>(), ParamSpec::NotSpec);
-  ListParam params(1, var);
-  signature = std::make_shared<FunctionSignature>(params, std::make_shared<Int>());
+  kind = NodeKind::Prev;
+  auto var = makeNode<ParamVar>(makeNode<Int>(), ParamSpec::NotSpec);
+  ListParam params{var};
+  signature = makeNode<FunctionSignature>(params, makeNode<Int>());
 }
 
 Chr::Chr() : BuildInFun("chr") {
-  auto var = std::make_shared<ParamVar>(std::make_shared<Int>(), ParamSpec::NotSpec);
-  ListParam params(1, var);
-  signature = std::make_shared<FunctionSignature>(params, std::make_shared<Char>());
+  kind = NodeKind::Chr;
+  auto var = makeNode<ParamVar>(makeNode<Int>(), ParamSpec::NotSpec);
+  ListParam params{var};
+  signature = makeNode<FunctionSignature>(params, makeNode<Char>());
 }
 
 Ord::Ord() : BuildInFun("ord") {
-  auto var = std::make_shared<ParamVar>(std::make_shared<Char>(), ParamSpec::NotSpec);
-  ListParam params(1, var);
-  signature = std::make_shared<FunctionSignature>(params, std::make_shared<Int>());
+  kind = NodeKind::Ord;
+  auto var = makeNode<ParamVar>(makeNode<Char>(), ParamSpec::NotSpec);
+  ListParam params{var};
+  signature = makeNode<FunctionSignature>(params, makeNode<Int>());
 }
 
 Write::Write(bool newLine) {
+  kind = NodeKind::Write;
   if (newLine)
-    setSymbolName("write");
+    setSymbolName(intern("write"));
   else
-    setSymbolName("writeln");
+    setSymbolName(intern("writeln"));
 }
 
-bool Write::isNewLine() { return getSymbolName() == "writeln"; }
+bool Write::isNewLine() { return getAtom() == intern("writeln"); }
 
 Read::Read(bool newLine) {
+  kind = NodeKind::Read;
   if (newLine)
-    setSymbolName("read");
+    setSymbolName(intern("read"));
   else
-    setSymbolName("readln");
+    setSymbolName(intern("readln"));
 }
 
-High::High() : BuildInFun("high") {}
+High::High() : BuildInFun("high") {
+  kind = NodeKind::High;
+}
 
-Low::Low() : BuildInFun("low") {}
+Low::Low() : BuildInFun("low") {
+  kind = NodeKind::Low;
+}
 
 Exit::Exit(ptr_Type returnType)
   : BuildInFun("exit"),
-    returnType(std::move(returnType)) {};
+    returnType(std::move(returnType)) {
+  kind = NodeKind::Exit;
+};
 
-Exit::Exit(ptr_Type returnType, std::shared_ptr<ParamVar> var)
+Exit::Exit(ptr_Type returnType, ptr_Param var)
   : BuildInFun("exit"),
-    returnType(std::move(returnType)), assignmentVar(std::move(var)) {}
+    returnType(std::move(returnType)), assignmentVar(std::move(var)) {
+  kind = NodeKind::Exit;
+}
 
 
-Void::Void() : SymType("void") {}
+Void::Void() : SymType("void") {
+  kind = NodeKind::Void;
+}
 
-Int::Int() : SymType("integer") {}
+Int::Int() : SymType("integer") {
+  kind = NodeKind::Int;
+}
 
-Double::Double() : SymType("double") {}
+Double::Double() : SymType("double") {
+  kind = NodeKind::Double;
+}
 
-Char::Char() : SymType("char") {}
+Char::Char() : SymType("char") {
+  kind = NodeKind::Char;
+}
 
-String::String() : SymType("string") {}
+String::String() : SymType("string") {
+  kind = NodeKind::String;
+}
 
-Boolean::Boolean() : SymType("boolean") {}
+Boolean::Boolean() : SymType("boolean") {
+  kind = NodeKind::Boolean;
+}
 
-TPointer::TPointer() : SymType("pointer") {}
+TPointer::TPointer() : SymType("pointer") {
+  kind = NodeKind::TPointer;
+}
 
 Alias::Alias(const Token& t)
-  : SymType(t, t.getString()) {}
+  : SymType(t, t.getAtom()) {
+  kind = NodeKind::Alias;
+}
 
 Alias::Alias(const Token& t, ptr_Type p)
-  : SymType(t, t.getString()), type(std::move(p)) {}
+  : SymType(t, t.getAtom()), type(std::move(p)) {
+  kind = NodeKind::Alias;
+}
 
-ForwardType::ForwardType(const Token& t) : Alias(t) {}
+ForwardType::ForwardType(const Token& t) : Alias(t) {
+  kind = NodeKind::ForwardType;
+}
 
 Pointer::Pointer(ptr_Type p)
-  : SymType(), typeBase(std::move(p)) {}
+  : SymType(), typeBase(std::move(p)) {
+  kind = NodeKind::Pointer;
+}
 
 Pointer::Pointer(const Token& t, ptr_Type p)
   : SymType(t),
-    typeBase(std::move(p)) {}
+    typeBase(std::move(p)) {
+  kind = NodeKind::Pointer;
+}
 
 StaticArray::StaticArray(const Token& d, ptr_Type t,
                          const StaticArray::BoundsType& b)
   : SymType(d),
-    bounds(b), typeElem(std::move(t)) {}
+    bounds(b), typeElem(std::move(t)) {
+  kind = NodeKind::StaticArray;
+}
 
 OpenArray::OpenArray(const Token& decl, ptr_Type type)
   : SymType(decl),
-    typeElem(std::move(type)) {}
+    typeElem(std::move(type)) {
+  kind = NodeKind::OpenArray;
+}
 
-Record::Record(const Token& t) : SymType(t) {}
+Record::Record(const Token& t) : SymType(t) {
+  kind = NodeKind::Record;
+}
 
 void Record::addVar(const ptr_Var& v) {
+  layout = nullptr;
   fieldsList.push_back(v);
   fields.insert(v);
 }
 
 FunctionSignature::FunctionSignature(ListParam t, ptr_Type r)
   : returnType(std::move(r)) {
+  kind = NodeKind::FunctionSignature;
   setParamsList(t);
 }
 
@@ -164,6 +223,7 @@ FunctionSignature::FunctionSignature(const Token & d,
     ListParam l, ptr_Type r)
   : SymType(d),
     returnType(std::move(r)) {
+  kind = NodeKind::FunctionSignature;
   setParamsList(l);
 }
 
@@ -175,34 +235,44 @@ void FunctionSignature::setParamsList(ListParam t) {
 }
 
 LocalVar::LocalVar(const Token& decl, ptr_Type type)
-  : SymVar(decl, std::move(type)) {}
+  : SymVar(decl, std::move(type)) {
+  kind = NodeKind::LocalVar;
+}
 
 GlobalVar::GlobalVar(const Token& decl, ptr_Type type)
-  : SymVar(decl, std::move(type)) {}
+  : SymVar(decl, std::move(type)) {
+  kind = NodeKind::GlobalVar;
+}
 
 ParamVar::ParamVar(ptr_Type type, ParamSpec s)
     : SymVar(type),
-      spec(s) {}
+      spec(s) {
+  kind = NodeKind::ParamVar;
+}
 
 ParamVar::ParamVar(const Token& decl, ptr_Type type, ParamSpec s)
   : SymVar(decl, type),
-    spec(s) {}
+    spec(s) {
+  kind = NodeKind::ParamVar;
+}
 
-ParamVar::ParamVar(std::string decl, ptr_Type type, ParamSpec s)
+ParamVar::ParamVar(Atom decl, ptr_Type type, ParamSpec s)
     : SymVar(decl, type),
-      spec(s) {}
+      spec(s) {
+  kind = NodeKind::ParamVar;
+}
 
 bool ParamVar::equals(ParamVar& p) const {
-  return spec == p.spec && type->equals(p.type.get());
+  return spec == p.spec && type->equals(p.type);
 }
 
-bool Tables::checkContain(const std::string& t) {
+bool Tables::checkContain(Atom t) {
   return tableType.checkContain(t) || tableVariable.checkContain(t) ||
           tableFunction.checkContain(t) || tableConst.checkContain(t);
 }
 
-void Tables::insertCheck(const std::shared_ptr<Symbol>& t) {
-  auto name = t->getSymbolName();
+void Tables::insertCheck(Symbol* t) {
+  auto name = t->getAtom();
 	if (checkContain(name) &&
     (!tableVariable.find(name)->isForward() ||
      !tableFunction.find(name)->isForward())) {
@@ -210,13 +280,13 @@ void Tables::insertCheck(const std::shared_ptr<Symbol>& t) {
   }
 }
 
-void Tables::insert(const std::shared_ptr<ForwardType>& f) {
+void Tables::insert(ForwardType* f) {
   forwardType.push_back(f);
   insertCheck(f);
   tableType.insert(f);
 }
 
-void Tables::insert(const std::shared_ptr<ForwardFunction>& f) {
+void Tables::insert(ForwardFunction* f) {
   forwardFunction.push_back(f);
   insertCheck(f);
   tableFunction.insert(f);
@@ -224,9 +294,9 @@ void Tables::insert(const std::shared_ptr<ForwardFunction>& f) {
 
 void Tables::resolveForwardType() {
   for (auto& e : forwardType) {
-  	auto name = e->getSymbolName();
+  	auto name = e->getAtom();
     if (tableType.find(name)->isForward()) {
-      throw SemanticException(e->getDeclPoint(), "Type \"" + name + "\" not resolve");
+      throw SemanticException(e->getDeclPoint(), "Type \"" + name.str() + "\" not resolve");
     }
     e->setRefType(tableType.find(name));
   }
@@ -235,15 +305,15 @@ void Tables::resolveForwardType() {
 
 void Tables::resolveForwardFunction() {
   for (auto& e : forwardFunction) {
-  	auto name = e->getSymbolName();
+  	auto name = e->getAtom();
     auto& function = tableFunction.find(name);
     if (function->isForward()) {
-      throw SemanticException(e->getDeclPoint(), "Function \"" + name + "\" not resolve");
+      throw SemanticException(e->getDeclPoint(), "Function \"" + name.str() + "\" not resolve");
     }
     if (function->getSignature() == nullptr) {
       throw std::logic_error("Signature nullptr");
     }
-    if (!function->getSignature()->equals(e->getSignature().get())) {
+    if (!function->getSignature()->equals(e->getSignature())) {
       throw SemanticException(e->getDeclPoint(),
         "Signature resolve function not equals with forward function " + e->getSymbolName());
     }
@@ -260,18 +330,76 @@ uint64_t Tables::sizeVar() {
   return s;
 }
 
-StackTable::StackTable(const Tables& global)
-	: stack(1, global) {}
+ptr_Symbol Scope::find(Atom n, SymbolKind k) const {
+  switch (k) {
+    case SymbolKind::Type: return tables->tableType.lookup(n);
+    case SymbolKind::Variable: return tables->tableVariable.lookup(n);
+    case SymbolKind::Const: return tables->tableConst.lookup(n);
+    case SymbolKind::Function: return tables->tableFunction.lookup(n);
+  }
+  return nullptr;
+}
+
+StackTable::StackTable() { pushEmpty(); }
+
+void StackTable::pushEmpty() { scope = makeNode<Scope>(makeNode<Tables>(), scope); }
+
+void StackTable::insert(ptr_Type t) { top().tableType.insert(t); }
+
+void StackTable::insert(ptr_Var v) { top().tableVariable.insert(v); }
 
-bool StackTable::checkContain(const std::string& n) {
-  for (auto iter = stack.rbegin(); iter != stack.rend(); ++iter) {
-    if (iter->checkContain(n)) {
+void StackTable::insert(ptr_Fun f) { top().tableFunction.insert(f); }
+
+void StackTable::insert(ForwardType* f) { top().insert(f); }
+
+void StackTable::insert(ForwardFunction* f) { top().insert(f); }
+
+void StackTable::replace(ptr_Type t) { top().tableType.replace(t); }
+
+void StackTable::replace(ptr_Fun f) { top().tableFunction.replace(f); }
+
+bool StackTable::checkContain(Atom n) {
+  for (auto s = scope; s != nullptr; s = s->getParent()) {
+    if (s->checkContain(n)) {
       return true;
     }
   }
   return false;
 }
 
+ptr_Symbol StackTable::lookup(Atom n, SymbolKind k, uint32_t* distance) {
+  uint32_t d = 0;
+  for (auto s = scope; s != nullptr; s = s->getParent(), ++d) {
+    if (auto symbol = s->find(n, k)) {
+      if (distance != nullptr) {
+        *distance = d;
+      }
+      return symbol;
+    }
+  }
+  return nullptr;
+}
+
+ptr_Symbol StackTable::find(Atom n, SymbolKind k, uint32_t* distance) {
+  auto symbol = lookup(n, k, distance);
+  if (symbol == nullptr) {
+    throw NotDefinedException(n.str());
+  }
+  return symbol;
+}
+
+ptr_Type StackTable::findType(Atom n) { return static_cast<ptr_Type>(find(n, SymbolKind::Type, nullptr)); }
+
+ptr_Fun StackTable::findFunction(Atom n, uint32_t* distance) {
+  return static_cast<ptr_Fun>(find(n, SymbolKind::Function, distance));
+}
+
+ptr_Const StackTable::findConst(Atom n) { return static_cast<ptr_Const>(find(n, SymbolKind::Const, nullptr)); }
+
+ptr_Var StackTable::findVar(Atom n, uint32_t* distance) {
+  return static_cast<ptr_Var>(find(n, SymbolKind::Variable, distance));
+}
+
 std::string toString(ParamSpec p) {
   switch (p) {
     case ParamSpec::NotSpec: {
@@ -302,131 +430,97 @@ bool BuildInFun::isBuildIn() const { return true; }
 
 // type equals
 
-bool SymType::checkAlias(SymType* s) const {
-  if (dynamic_cast<Alias*>(s)) {
-    return equals(dynamic_cast<Alias*>(s)->getRefType().get());
-  } else if (dynamic_cast<ForwardType*>(s)) {
-    return equals(dynamic_cast<ForwardType*>(s)->getRefType().get());
-  }
-  return false;
-}
-
-bool Int::equals(SymType* s) const {
-  return dynamic_cast<Int*>(s) || checkAlias(s);
-}
-
-bool Double::equals(SymType* s) const {
-  return dynamic_cast<Double*>(s) || checkAlias(s);
-}
-
-bool Char::equals(SymType* s) const {
-  return dynamic_cast<Char*>(s) || checkAlias(s);
-}
-
-bool Boolean::equals(SymType* s) const {
-  return dynamic_cast<Boolean*>(s) || checkAlias(s);
-}
-
-bool TPointer::equals(SymType* s) const {
-  return dynamic_cast<TPointer*>(s) || checkAlias(s);
-}
-
-bool Alias::equals(SymType* s) const {
-  return type->equals(s);
-}
-
-bool Pointer::equals(SymType* s) const {
-  if (dynamic_cast<Pointer*>(s)) {
-    return typeBase->equals(dynamic_cast<Pointer*>(s)->typeBase.get());
+ptr_Type SymType::getCanonical() {
+  if (canonical == nullptr) {
+    canonical = TypeTable::current().canonical(*this);
   }
-  return checkAlias(s);
+  return canonical;
 }
 
-bool StaticArray::equals(SymType* s) const {
-  if (dynamic_cast<StaticArray*>(s)) {
-    auto p = dynamic_cast<StaticArray*>(s);
-    return p->bounds == bounds && typeElem->equals(p->typeElem.get());
-  }
-  return checkAlias(s);
-}
-
-bool OpenArray::equals(SymType* s) const {
-  return false;
+bool SymType::equals(SymType* s) {
+  auto c = getCanonical();
+  return c != nullptr && c == s->getCanonical();
 }
 
-bool OpenArray::equalsForCheckArgument(SymType* s) const {
+bool OpenArray::equalsForCheckArgument(SymType* s) {
   if (dynamic_cast<StaticArray*>(s)) {
     auto p = dynamic_cast<StaticArray*>(s);
-    auto copy = std::make_shared<StaticArray>(*p);
+    auto copy = makeNode<StaticArray>(*p);
     copy->getBounds().pop_front();
     if (copy->getBounds().empty()) {
-      return typeElem->equalsForCheckArgument(copy->getRefType().get());
+      return typeElem->equalsForCheckArgument(copy->getRefType());
     } else {
-      return typeElem->equalsForCheckArgument(copy.get());
+      return typeElem->equalsForCheckArgument(copy);
     }
   } if (dynamic_cast<Alias*>(s)) {
     auto p = dynamic_cast<Alias*>(s);
-    return equalsForCheckArgument(p->getRefType().get());
+    return equalsForCheckArgument(p->getRefType());
   }
   return false;
 }
 
-bool Record::equals(SymType* s) const {
-  if (dynamic_cast<Record*>(s)) {
-    auto record = dynamic_cast<Record*>(s);
-    return (!isAnonymous() && s->getSymbolName() == this->getSymbolName()) ||
-           (isAnonymous() && this == record);
-  }
-  return checkAlias(s);
-}
-
-bool FunctionSignature::equals(SymType* s) const  {
-  if (dynamic_cast<FunctionSignature*>(s)) {
-    auto p = dynamic_cast<FunctionSignature*>(s);
-    bool eq = (isProcedure() && p->isProcedure()) || returnType->equals(p->returnType.get());
-    eq &= paramsList.size() == p->paramsList.size();
-    auto first = paramsList.begin();
-    auto second = p->paramsList.begin();
-    for (; eq && first != paramsList.end(); ++first, ++second) {
-      eq &= (*first)->equals(**second);
-    }
-    return eq;
-  }
-  return checkAlias(s);
-}
-
-bool ForwardType::equals(SymType* s) const {
-  if (dynamic_cast<ForwardType*>(s)) {
-    auto p = dynamic_cast<ForwardType*>(s);
-    return type->equals(p->type.get());
-  }
-  return checkAlias(s);
-}
-
   // in byte
 uint64_t SymVar::size() const { return type->size(); }
 
-uint64_t SymType::size() const { return 8; }
-uint64_t Void::size() const { return 0; }
-uint64_t String::size() const { return 0; }
-uint64_t Alias::size() const { return type->size(); }
-
-uint64_t StaticArray::size() const {
-  uint64_t size_type = typeElem->size();
-  for (auto& e : bounds) {
-    size_type *= e.second - e.first + 1;
-  }
-  return size_type;
+namespace {
+uint64_t alignTo(uint64_t n, uint64_t align) { return (n + align - 1) / align * align; }
 }
 
-uint64_t OpenArray::size() const { return 0; }
-
-uint64_t Record::size() const {
-  uint64_t size = 0;
-  for (auto& e : fieldsList) {
-    size += e->size();
+const TypeLayout& SymType::getLayout() {
+  if (layout != nullptr) {
+    return *layout;
+  }
+  switch (kind) {
+    case NodeKind::Alias:
+    case NodeKind::ForwardType: {
+      layout = &static_cast<Alias*>(this)->getRefType()->getLayout();
+      return *layout;
+    }
+    default:
+      break;
+  }
+  auto l = makeNode<TypeLayout>();
+  switch (kind) {
+    case NodeKind::Void:
+    case NodeKind::String:
+    case NodeKind::OpenArray: {
+      break;
+    }
+    case NodeKind::StaticArray: {
+      auto a = static_cast<StaticArray*>(this);
+      auto& elem = a->getRefType()->getLayout();
+      auto& bounds = a->getBounds();
+      l->strides.resize(bounds.size());
+      uint64_t stride = 1;
+      auto it = bounds.rbegin();
+      for (auto s = l->strides.rbegin(); s != l->strides.rend(); ++s, ++it) {
+        *s = stride;
+        stride *= it->second - it->first + 1;
+      }
+      l->size = elem.size * stride;
+      l->align = elem.align;
+      break;
+    }
+    case NodeKind::Record: {
+      uint64_t offset = 0;
+      for (auto& e : static_cast<Record*>(this)->getFieldList()) {
+        auto& field = e->getVarType()->getLayout();
+        offset = alignTo(offset, field.align);
+        l->offsets.emplace(e->getAtom(), offset);
+        offset += field.size;
+        l->align = std::max(l->align, field.align);
+      }
+      l->size = alignTo(offset, l->align);
+      break;
+    }
+    default: {
+      l->size = 8;
+      l->align = 8;
+      break;
+    }
   }
-  return size;
+  layout = l;
+  return *layout;
 }
 
 uint64_t ParamVar::size() const {
@@ -437,98 +531,21 @@ uint64_t ParamVar::size() const {
 }
 
 
-uint64_t Record::offset(const std::string& name) {
-  uint64_t offset = 0;
-  auto iter = fieldsList.begin();
-  while (iter != fieldsList.end() && (*iter)->getSymbolName() != name) {
-    offset += (*iter)->size();
-    ++iter;
-  }
-  return offset;
-}
-
 bool SymType::isTrivial() const {
   return this->isInt() || this->isDouble() ||
          this->isChar() || this->isPointer() ||
          this->isProcedureType();
 }
 
-// todo fooooooo
-// who replace ????
-
-bool StackTable::isType(const std::string& n) {
-	for (auto iter = stack.rbegin(); iter != stack.rend(); ++iter) {
-		if (iter->tableType.checkContain(n)) {
-			return true;
-		}
-	}
-	return false;
-}
-
-bool StackTable::isFunction(const std::string& n) {
-	for (auto iter = stack.rbegin(); iter != stack.rend(); ++iter) {
-		if (iter->tableFunction.checkContain(n)) {
-			return true;
-		}
-	}
-	return false;
-}
-
-ptr_Type StackTable::findType(const std::string& n) {
-	for (auto iter = stack.rbegin(); iter != stack.rend(); ++iter) {
-		if (iter->tableType.checkContain(n)) {
-			return iter->tableType.find(n);
-		}
-	}
-	throw NotDefinedException(n);
-}
-
-std::shared_ptr<SymFun> StackTable::findFunction(const std::string& n) {
-	for (auto iter = stack.rbegin(); iter != stack.rend(); ++iter) {
-		if (iter->tableFunction.checkContain(n)) {
-			return iter->tableFunction.find(n);
-		}
-	}
-	throw NotDefinedException(n);
-}
-
-bool StackTable::isConst(const std::string& n) {
-	for (auto iter = stack.rbegin(); iter != stack.rend(); ++iter) {
-		if (iter->tableConst.checkContain(n)) {
-			return true;
-		}
-	}
-	return false;
-}
-
-std::shared_ptr<Const> StackTable::findConst(const std::string& n) {
-	for (auto iter = stack.rbegin(); iter != stack.rend(); ++iter) {
-		if (iter->tableConst.checkContain(n)) {
-			return iter->tableConst.find(n);
-		}
-	}
-	throw NotDefinedException(n);
-}
-
-bool StackTable::isVar(const std::string& n) {
-	for (auto iter = stack.rbegin(); iter != stack.rend(); ++iter) {
-		if (iter->tableVariable.checkContain(n)) {
-			return true;
-		}
-	}
-	return false;
-}
-
-ptr_Var StackTable::findVar(const std::string& n) {
-	for (auto iter = stack.rbegin(); iter != stack.rend(); ++iter) {
-		if (iter->tableVariable.checkContain(n)) {
-			return iter->tableVariable.find(n);
-		}
-	}
-	throw NotDefinedException(n);
+NodeKind SymType::aliasedKind() const {
+  const SymType* t = this;
+  while ((t->kind == NodeKind::Alias || t->kind == NodeKind::ForwardType) &&
+         static_cast<const Alias*>(t)->getRefType() != nullptr) {
+    t = static_cast<const Alias*>(t)->getRefType();
+  }
+  return t->kind;
 }
 
-
 // accept
 
 void Int::accept(Visitor& v) { v.visit(*this); }
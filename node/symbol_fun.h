@@ -9,17 +9,16 @@ class Function : public SymFun {
  public:
   //using SymFun::SymFun;
   Function(const Token&, ptr_Sign);
-  Function(const Token&, ptr_Sign, ptr_Stmt, Tables);
-  ~Function() override;
+  Function(const Token&, ptr_Sign, ptr_Stmt, Tables&);
 
   // todo remove virtual
   ptr_Stmt& getBody() override { return body; }
-  Tables& getTable() override  { return localVar; }
+  Tables& getTable() override  { return *localVar; }
 	void accept(Visitor& v) override;
 
  private:
-	Tables localVar;
-	ptr_Stmt body;
+	Tables* localVar = nullptr;
+	ptr_Stmt body = nullptr;
 };
 
 class ForwardFunction : public SymFun {
@@ -40,7 +39,7 @@ class ForwardFunction : public SymFun {
  auto& getFunction() { return  function; }
 
  private:
-	ptr_Fun function;
+	ptr_Fun function = nullptr;
 };
 
 class BuildInFun : public SymFun {
@@ -50,18 +49,18 @@ class BuildInFun : public SymFun {
 
 class MainFunction : public SymFun {
  public:
-  MainFunction(Tables t, ptr_Stmt b);
+  MainFunction(Tables& t, ptr_Stmt b);
 
   void accept(Visitor& v) override;
   // todo remove
   bool isBuildIn() const override { return false; }
   // todo remove virtual
 	ptr_Stmt& getBody() override { return body; }
-	Tables& getTable() { return decl; }
+	Tables& getTable() { return *decl; }
 
  private:
-  ptr_Stmt body;
-  Tables decl;
+  ptr_Stmt body = nullptr;
+  Tables* decl = nullptr;
 };
 
 class Write : public BuildInFun {
@@ -128,7 +127,7 @@ class Low : public BuildInFun {
 class Exit : public BuildInFun {
  public:
   Exit(ptr_Type returnType);
-  Exit(ptr_Type returnType, std::shared_ptr<ParamVar> var);
+  Exit(ptr_Type returnType, ptr_Param var);
 
 	auto& getReturnType() { return returnType; }
 	auto& getVar() { return assignmentVar; }
@@ -136,6 +135,6 @@ class Exit : public BuildInFun {
 
 
  private:
-  ptr_Type returnType;
-  std::shared_ptr<ParamVar> assignmentVar = nullptr;
+  ptr_Type returnType = nullptr;
+  ptr_Param assignmentVar = nullptr;
 };
\ No newline at end of file
@@ -3,32 +3,49 @@
 #include "astnode.h"
 #include "table_symbol.h"
 #include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 class Record;
 class FunctionSignature;
 class StaticArray;
 
+// Size and placement of a type, computed once on first use. An alias
+// shares the layout of its type.
+struct TypeLayout {
+  uint64_t size = 0;
+  uint64_t align = 1;
+  // static array: elements between consecutive indices of each dimension
+  std::vector<uint64_t> strides;
+  // record: byte offset of each field
+  std::unordered_map<Atom, uint64_t> offsets;
+};
+
 class SymType : public Symbol {
  public:
   using Symbol::Symbol;
-  // todo normal double dispatch
-  virtual bool equals(SymType* s) const = 0;
+  // a copy is changed after, it gets its own canonical type and layout
+  SymType(const SymType& t) : Symbol(t) {}
+
+  // equal types share one canonical type, see TypeTable
+  bool equals(SymType* s);
+  ptr_Type getCanonical();
   // todo move to cpp
-  virtual bool equalsForCheckArgument(SymType* s) const { return equals(s); } // вызывет paramenter передается argument
-
-  // todo how remove this
-  virtual bool isVoid() const { return false; }
-  virtual bool isString() const { return false; }
-  virtual bool isInt() const { return false; }
-  virtual bool isDouble() const { return false; }
-  virtual bool isBool() const { return false; }
-  virtual bool isChar() const { return false; }
-  virtual bool isPurePointer() const { return false; }
-  virtual bool isTypePointer() const { return false; }
+  virtual bool equalsForCheckArgument(SymType* s) { return equals(s); } // вызывет paramenter передается argument
+
+  // answered from the kind, an alias asks the type it names
+  bool isVoid() const { return is(NodeKind::Void); }
+  bool isString() const { return is(NodeKind::String); }
+  bool isInt() const { return is(NodeKind::Int); }
+  bool isDouble() const { return is(NodeKind::Double); }
+  bool isBool() const { return is(NodeKind::Boolean); }
+  bool isChar() const { return is(NodeKind::Char); }
+  bool isPurePointer() const { return is(NodeKind::TPointer); }
+  bool isTypePointer() const { return is(NodeKind::Pointer); }
   bool isPointer() const { return isTypePointer() || isPurePointer(); }
-  virtual bool isProcedureType() const { return false; }
-  virtual bool isOpenArray() const { return false; }
-  virtual bool isStaticArray() const { return false; }
+  bool isProcedureType() const { return is(NodeKind::FunctionSignature); }
+  bool isOpenArray() const { return is(NodeKind::OpenArray); }
+  bool isStaticArray() const { return is(NodeKind::StaticArray); }
   bool isTrivial() const;
 
   // todo remove it
@@ -37,71 +54,63 @@ class SymType : public Symbol {
   virtual FunctionSignature* getSignature() { return nullptr; }
   virtual StaticArray* getStaticArray() { return nullptr; }
 
-  // todo remove
-  virtual uint64_t size() const;
+  // in byte
+  uint64_t size() { return getLayout().size; }
+  const TypeLayout& getLayout();
 
  protected:
-  bool checkAlias(SymType* s) const;
+  const TypeLayout* layout = nullptr;
+
+ private:
+  bool is(NodeKind k) const {
+    return kind == NodeKind::Alias || kind == NodeKind::ForwardType ? aliasedKind() == k : kind == k;
+  }
+  NodeKind aliasedKind() const;
+
+  // computed on first compare, nullptr while the type equals no type
+  ptr_Type canonical = nullptr;
 };
 
 class Void : public SymType {
  public:
   Void();
-  bool isVoid() const override { return true; }
   void accept(Visitor& v) override;
-  // todo move to cpp
-  bool equals(SymType* s) const override { return false; }
-  uint64_t size() const override;
 };
 
 class Int : public SymType {
  public:
   Int();
   void accept(Visitor& v) override;
-  bool equals(SymType* s) const override;
-  bool isInt() const override { return true; }
 };
 
 class Double : public SymType {
  public:
   Double();
   void accept(Visitor& v) override;
-  bool equals(SymType* s) const override;
-  bool isDouble() const override { return true; }
 };
 
 class Char : public SymType {
  public:
   Char();
   void accept(Visitor& v) override;
-  bool equals(SymType* s) const override;
-  bool isChar() const override { return true; }
 };
 
 class String : public SymType {
  public:
   String();
   void accept(Visitor& v) override;
-  // todo move to cpp
-  bool equals(SymType* s) const override { return s->isString(); }
-  bool isString() const override { return true; }
-  uint64_t size() const override;
 };
 
 class Boolean : public SymType {
  public:
   Boolean();
   void accept(Visitor& v) override;
-  bool equals(SymType* s) const override;
-  bool isBool() const override { return true; }
 };
 
 class TPointer : public SymType {
  public:
   TPointer();
   void accept(Visitor& v) override;
-  bool equals(SymType* s) const override;
-  bool isPurePointer() const override { return true; }
 };
 
 class Alias : public SymType {
@@ -110,17 +119,6 @@ class Alias : public SymType {
   Alias(const Token&, ptr_Type);
 
   void accept(Visitor& v) override;
-  bool equals(SymType* s) const override;
-
-  bool isInt() const override { return type->isInt(); }
-  bool isDouble() const override { return type->isDouble(); }
-  bool isBool() const override { return type->isBool(); }
-  bool isChar() const override { return type->isChar(); }
-  bool isPurePointer() const override { return type->isPurePointer(); }
-  bool isTypePointer() const override { return type->isTypePointer(); }
-  bool isProcedureType() const override { return type->isProcedureType(); }
-  bool isStaticArray() const override { return type->isStaticArray(); }
-  bool isOpenArray() const override { return type->isOpenArray(); }
 
   // todo remove this
   ptr_Type getPointerBase() override { return type->getPointerBase(); }
@@ -128,12 +126,11 @@ class Alias : public SymType {
   FunctionSignature* getSignature() override { return type->getSignature(); }
   StaticArray* getStaticArray() override { return type->getStaticArray(); }
 
-  // todo remove virtual
-  uint64_t size() const override;
   auto& getRefType() { return type; }
+  const ptr_Type& getRefType() const { return type; }
 
  protected:
-  ptr_Type type;
+  ptr_Type type = nullptr;
 };
 
 class ForwardType : public Alias {
@@ -141,7 +138,6 @@ class ForwardType : public Alias {
   ForwardType(const Token& t);
 
   void accept(Visitor& v) override;
-  bool equals(SymType* s) const override;
   // todo remove virtual
   bool isForward() const override;
   void setRefType(ptr_Type t) { type = std::move(t); }
@@ -154,14 +150,12 @@ class Pointer : public SymType {
   Pointer(const Token& t, ptr_Type p);
 
   void accept(Visitor& v) override;
-  bool equals(SymType* s) const override;
-  bool isTypePointer() const override { return true; }
   // todo remove virtual
   ptr_Type getPointerBase() override { return typeBase; }
   void setPointerBase(ptr_Type t) { typeBase = t; }
 
  private:
-  ptr_Type typeBase;
+  ptr_Type typeBase = nullptr;
 };
 
 
@@ -171,17 +165,14 @@ class StaticArray : public SymType {
   StaticArray(const Token&, ptr_Type, const BoundsType&);
 
   void accept(Visitor& v) override;
-  bool equals(SymType* s) const override;
-  bool isStaticArray() const override { return true; }
   StaticArray* getStaticArray() { return this; }
-  uint64_t size() const override;
 
   auto& getBounds() { return bounds; }
   auto& getRefType() { return typeElem; }
 
  private:
   BoundsType bounds;
-  ptr_Type typeElem;
+  ptr_Type typeElem = nullptr;
 };
 
 class OpenArray : public SymType {
@@ -189,15 +180,12 @@ class OpenArray : public SymType {
   OpenArray(const Token& decl, ptr_Type type);
 
   void accept(Visitor& v) override;
-  bool equals(SymType* s) const override;
-  bool equalsForCheckArgument(SymType* s) const override;
-  bool isOpenArray() const override { return true; }
-  uint64_t size() const override;
+  bool equalsForCheckArgument(SymType* s) override;
 
   auto& getRefType() { return typeElem; }
 
  private:
-  ptr_Type typeElem;
+  ptr_Type typeElem = nullptr;
 };
 
 class Record : public SymType {
@@ -206,11 +194,10 @@ class Record : public SymType {
 
   void addVar(const ptr_Var&);
   auto& getTable() { return fields; }
+  auto& getFieldList() { return fieldsList; }
 
   void accept(Visitor& v) override;
-  bool equals(SymType* s) const override;
-  uint64_t size() const override;
-  uint64_t offset(const std::string& name);
+  uint64_t offset(Atom name) { return getLayout().offsets.at(name); }
   Record* getRecord() override { return this; }
 
  private:
@@ -229,13 +216,11 @@ class FunctionSignature : public SymType {
   void setParamsList(ListParam t);
   bool isProcedure() const { return returnType->isVoid(); }
 
-  bool isProcedureType() const override { return true; }
   void accept(Visitor& v) override;
-  bool equals(SymType* s) const override;
   FunctionSignature* getSignature() override { return this; }
 
  private:
-  TableSymbol<std::shared_ptr<ParamVar>> paramsTable;
+  TableSymbol<ptr_Param> paramsTable;
   ListParam paramsList;
-  ptr_Type returnType;
+  ptr_Type returnType = nullptr;
 };
@@ -40,7 +40,7 @@ class ParamVar : public SymVar {
  public:
 	ParamVar(ptr_Type, ParamSpec);
 	ParamVar(const Token&, ptr_Type, ParamSpec);
-	ParamVar(std::string, ptr_Type, ParamSpec);
+	ParamVar(Atom, ptr_Type, ParamSpec);
 
 	void accept(Visitor& v) override;
 	bool equals(ParamVar&) const;
@@ -58,6 +58,6 @@ class ParamVar : public SymVar {
 class Const : public SymVar {
  public:
   using SymVar::SymVar;
-  ptr_Expr value;
+  ptr_Expr value = nullptr;
   void accept(Visitor& v) override;
 };
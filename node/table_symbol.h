@@ -1,101 +1,209 @@
 #pragma once
 
 #include <string>
-#include <map>
 #include <list>
-#include <memory>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
+#include <stdexcept>
 
 #include "astnode.h"
 #include "token.h"
 
+// Symbols of one kind by name. Values sit in a dense array in insertion
+// order, which is also the iteration order; a power of two open addressing
+// index with linear probing maps a name to its position.
 template <typename T>
 class TableSymbol {
  public:
   TableSymbol() = default;
 
   void insert(T);
-  bool checkContain(const std::string&);
-  T& find(const std::string&);
+  bool checkContain(Atom);
+  T& find(Atom);
+  // nullptr if not declared
+  T lookup(Atom) const;
   void replace(T);
   auto begin() { return order.begin(); };
   auto end() { return order.end(); }
 
  private:
-  std::map<std::string, T> table;
+  struct Slot {
+    uint32_t atom = 0;
+    // position in order + 1, 0 - empty slot
+    uint32_t index = 0;
+  };
+
+  static std::size_t hash(uint32_t atom) { return atom * std::size_t{0x9E3779B1}; }
+  uint32_t findIndex(Atom) const;
+  void place(uint32_t atom, uint32_t index);
+  void grow();
+
+  std::vector<Slot> slots;
   std::vector<T> order;
 };
 
+template<class T>
+uint32_t TableSymbol<T>::findIndex(Atom n) const {
+  if (slots.empty()) {
+    return 0;
+  }
+  auto mask = slots.size() - 1;
+  for (auto i = hash(n.getId()) & mask;; i = (i + 1) & mask) {
+    if (slots[i].index == 0 || slots[i].atom == n.getId()) {
+      return slots[i].index;
+    }
+  }
+}
+
+template<class T>
+void TableSymbol<T>::place(uint32_t atom, uint32_t index) {
+  auto mask = slots.size() - 1;
+  auto i = hash(atom) & mask;
+  while (slots[i].index != 0) {
+    i = (i + 1) & mask;
+  }
+  slots[i] = Slot{atom, index};
+}
+
+template<class T>
+void TableSymbol<T>::grow() {
+  slots.assign(std::max<std::size_t>(8, slots.size() * 2), Slot{});
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    place(order[i]->getAtom().getId(), static_cast<uint32_t>(i + 1));
+  }
+}
+
 template<class T>
 void TableSymbol<T>::replace(T t) {
-  table[t->getSymbolName()] = t ;
-  std::replace_if(order.begin(), order.end(),
-    [&t](T e) { return t->getSymbolName() == e->getSymbolName(); }, t);
+  auto index = findIndex(t->getAtom());
+  if (index == 0) {
+    insert(t);
+    return;
+  }
+  order[index - 1] = t;
 }
 
 template<class T>
 void TableSymbol<T>::insert(T t) {
-  if (checkContain(t->getSymbolName())) {
+  if (checkContain(t->getAtom())) {
     throw std::logic_error("Already defined " + t->getSymbolName());
   }
-  table[t->getSymbolName()] = t;
   order.push_back(t);
+  if (order.size() * 2 > slots.size()) {
+    grow();
+  } else {
+    place(t->getAtom().getId(), static_cast<uint32_t>(order.size()));
+  }
 }
 
 template<class T>
-bool TableSymbol<T>::checkContain(const std::string& n) {
-  return table.count(n) > 0;
+bool TableSymbol<T>::checkContain(Atom n) {
+  return findIndex(n) != 0;
 }
 
 template<class T>
-T& TableSymbol<T>::find(const std::string& n) {
-  return table.at(n);
+T& TableSymbol<T>::find(Atom n) {
+  auto index = findIndex(n);
+  if (index == 0) {
+    throw std::out_of_range("Table symbol: not found " + n.str());
+  }
+  return order[index - 1];
+}
+
+template<class T>
+T TableSymbol<T>::lookup(Atom n) const {
+  auto index = findIndex(n);
+  return index == 0 ? nullptr : order[index - 1];
 }
 
 class Tables {
  public:
-  bool checkContain(const std::string&);
-  void insert(const std::shared_ptr<ForwardType>&);
-  void insert(const std::shared_ptr<ForwardFunction>&);
+  bool checkContain(Atom);
+  void insert(ForwardType*);
+  void insert(ForwardFunction*);
   uint64_t sizeVar();
 
   void resolveForwardType();
   void resolveForwardFunction();
-  TableSymbol<std::shared_ptr<SymType>> tableType;
-  TableSymbol<std::shared_ptr<SymVar>> tableVariable;
-  TableSymbol<std::shared_ptr<Const>> tableConst;
-  TableSymbol<std::shared_ptr<SymFun>> tableFunction;
+  TableSymbol<ptr_Type> tableType;
+  TableSymbol<ptr_Var> tableVariable;
+  TableSymbol<ptr_Const> tableConst;
+  TableSymbol<ptr_Fun> tableFunction;
  
  private:
-  void insertCheck(const std::shared_ptr<Symbol>&);
-  std::list<std::shared_ptr<ForwardType>> forwardType;
-  std::list<std::shared_ptr<ForwardFunction>> forwardFunction;
+  void insertCheck(Symbol*);
+  std::list<ForwardType*> forwardType;
+  std::list<ForwardFunction*> forwardFunction;
 };
 
-class StackTable {
+enum class SymbolKind : uint8_t {
+  Type,
+  Variable,
+  Const,
+  Function
+};
+
+// One level of the scope chain: the declarations of the program or of a
+// function and a link to the enclosing scope. Lookups by name and kind go
+// to the table of that kind in the Tables.
+class Scope {
  public:
-  StackTable() = default;
-  StackTable(const Tables& global);
+  Scope(Tables* t, Scope* parent) : tables(t), parent(parent) {}
 
-  void push(const Tables& t) { stack.push_back(t); }
-  void pushEmpty() { stack.push_back(Tables()); }
-  void pop() { stack.pop_back(); }
-  Tables& top() { return stack.back(); }
-  bool isEmpty() { return stack.empty(); }
+  Tables& getTables() { return *tables; }
+  Scope* getParent() { return parent; }
 
-  bool checkContain(const std::string& n);
+  // in this scope only, nullptr if not declared here
+  ptr_Symbol find(Atom n, SymbolKind k) const;
+  bool checkContain(Atom n) const { return tables->checkContain(n); }
 
-  bool isType(const std::string& n);
-  bool isFunction(const std::string& n);
-  bool isConst(const std::string& n);
-  bool isVar(const std::string& n);
+ private:
+  Tables* tables;
+  Scope* parent;
+};
 
-  ptr_Type findType(const std::string&);
-  ptr_Fun findFunction(const std::string&);
-  ptr_Const findConst(const std::string&);
-  ptr_Var findVar(const std::string&);
+// Chain of scopes from the innermost one. Scopes live in the arena and are
+// never copied, push and pop only move the innermost pointer, and the
+// Tables of a popped scope stay valid for the function that owns them.
+class StackTable {
+ public:
+  // with an empty global scope
+  StackTable();
+
+  void pushEmpty();
+  void pop() { scope = scope->getParent(); }
+  Tables& top() { return scope->getTables(); }
+  bool isEmpty() { return scope == nullptr; }
+
+  void insert(ptr_Type);
+  void insert(ptr_Var);
+  void insert(ptr_Fun);
+  void insert(ForwardType*);
+  void insert(ForwardFunction*);
+  void replace(ptr_Type);
+  void replace(ptr_Fun);
+
+  // in the innermost scope only
+  bool checkContainTop(Atom n) { return scope->checkContain(n); }
+  ptr_Symbol findTop(Atom n, SymbolKind k) { return scope->find(n, k); }
+
+  bool checkContain(Atom n);
+
+  bool isType(Atom n) { return lookup(n, SymbolKind::Type) != nullptr; }
+  bool isFunction(Atom n) { return lookup(n, SymbolKind::Function) != nullptr; }
+  bool isConst(Atom n) { return lookup(n, SymbolKind::Const) != nullptr; }
+  bool isVar(Atom n) { return lookup(n, SymbolKind::Variable) != nullptr; }
+
+  ptr_Type findType(Atom);
+  // distance - number of scopes out from the innermost one to the declaration
+  ptr_Fun findFunction(Atom, uint32_t* distance = nullptr);
+  ptr_Const findConst(Atom);
+  ptr_Var findVar(Atom, uint32_t* distance = nullptr);
 
  private:
-  std::list<Tables> stack;
+  Scope* scope = nullptr;
+
+  ptr_Symbol lookup(Atom n, SymbolKind k, uint32_t* distance = nullptr);
+  ptr_Symbol find(Atom n, SymbolKind k, uint32_t* distance);
 };
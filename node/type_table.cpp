@@ -0,0 +1,114 @@
+#include "type_table.h"
+
+#include <stdexcept>
+
+#include "arena.h"
+#include "symbol_var.h"
+
+namespace {
+thread_local TypeTable* currentTable = nullptr;
+
+template <class T>
+void append(std::string& key, const T& v) {
+  key.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+}
+
+TypeTable::TypeTable()
+  : intType(makeNode<Int>()),
+    doubleType(makeNode<Double>()),
+    charType(makeNode<Char>()),
+    booleanType(makeNode<Boolean>()),
+    pointerType(makeNode<TPointer>()),
+    stringType(makeNode<String>()),
+    voidType(makeNode<Void>()) {}
+
+TypeTable& TypeTable::current() {
+  if (currentTable == nullptr) {
+    throw std::logic_error("No type table for a type compare");
+  }
+  return *currentTable;
+}
+
+TypeTable::Scope::Scope(TypeTable& t)
+  : previous(currentTable) {
+  currentTable = &t;
+}
+
+TypeTable::Scope::~Scope() { currentTable = previous; }
+
+ptr_Type TypeTable::intern(const std::string& key, SymType& t) {
+  return composites.try_emplace(key, &t).first->second;
+}
+
+ptr_Type TypeTable::canonical(SymType& t) {
+  switch (t.getKind()) {
+    case NodeKind::Int:
+      return intType;
+    case NodeKind::Double:
+      return doubleType;
+    case NodeKind::Char:
+      return charType;
+    case NodeKind::Boolean:
+      return booleanType;
+    case NodeKind::TPointer:
+      return pointerType;
+    case NodeKind::String:
+      return stringType;
+    case NodeKind::Void:
+    case NodeKind::OpenArray:
+      return nullptr;
+    case NodeKind::Alias:
+    case NodeKind::ForwardType: {
+      auto ref = static_cast<Alias&>(t).getRefType();
+      return ref == nullptr ? nullptr : ref->getCanonical();
+    }
+    case NodeKind::Record:
+      return &t;
+    case NodeKind::Pointer: {
+      auto base = t.getPointerBase()->getCanonical();
+      if (base == nullptr) {
+        return nullptr;
+      }
+      std::string key{'P'};
+      append(key, base);
+      return intern(key, t);
+    }
+    case NodeKind::StaticArray: {
+      auto& a = static_cast<StaticArray&>(t);
+      auto elem = a.getRefType()->getCanonical();
+      if (elem == nullptr) {
+        return nullptr;
+      }
+      std::string key{'A'};
+      append(key, elem);
+      for (auto& e : a.getBounds()) {
+        append(key, e);
+      }
+      return intern(key, t);
+    }
+    case NodeKind::FunctionSignature: {
+      auto& f = static_cast<FunctionSignature&>(t);
+      std::string key{'F'};
+      ptr_Type ret = nullptr;
+      if (!f.isProcedure()) {
+        ret = f.getReturnType()->getCanonical();
+        if (ret == nullptr) {
+          return nullptr;
+        }
+      }
+      append(key, ret);
+      for (auto& e : f.getParamList()) {
+        auto type = e->getVarType()->getCanonical();
+        if (type == nullptr) {
+          return nullptr;
+        }
+        append(key, e->getSpec());
+        append(key, type);
+      }
+      return intern(key, t);
+    }
+    default:
+      throw std::logic_error("Type table: not a type");
+  }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "symbol_type.h"
+
+// Canonical types of one compilation. An alias and the type it names,
+// and structurally identical arrays, pointers and signatures, share one
+// canonical type, so type equality is a pointer compare. Records are
+// nominal, each record is its own canonical type. Void, open arrays and
+// the types built over them have none and equal no type.
+class TypeTable {
+ public:
+  TypeTable();
+  TypeTable(const TypeTable&) = delete;
+  TypeTable& operator=(const TypeTable&) = delete;
+
+  ptr_Type canonical(SymType& t);
+
+  // shared unnamed instances for the types of expressions
+  ptr_Type getInt() { return intType; }
+  ptr_Type getDouble() { return doubleType; }
+  ptr_Type getChar() { return charType; }
+  ptr_Type getBoolean() { return booleanType; }
+  ptr_Type getTPointer() { return pointerType; }
+  ptr_Type getString() { return stringType; }
+  ptr_Type getVoid() { return voidType; }
+
+  static TypeTable& current();
+
+  // makes a type table current for SymType::equals on this thread
+  class Scope {
+   public:
+    explicit Scope(TypeTable& t);
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope();
+
+   private:
+    TypeTable* previous;
+  };
+
+ private:
+  ptr_Type intern(const std::string& key, SymType& t);
+
+  ptr_Type intType;
+  ptr_Type doubleType;
+  ptr_Type charType;
+  ptr_Type booleanType;
+  ptr_Type pointerType;
+  ptr_Type stringType;
+  ptr_Type voidType;
+  // structural key of a composite type -> its canonical type
+  std::unordered_map<std::string, ptr_Type> composites;
+};
@@ -0,0 +1,131 @@
+#include "visitor.h"
+
+// Expression
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(Variable& v) { count(v); }
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(Literal& l) { count(l); }
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(BinaryOperation& b) {
+  count(b);
+  walk(*b.getSubLeft());
+  walk(*b.getSubRight());
+}
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(UnaryOperation& u) {
+  count(u);
+  walk(*u.getSubNode());
+}
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(ArrayAccess& a) {
+  count(a);
+  walk(*a.getSubNode());
+  for (auto& e : a.getListIndex()) {
+    walk(*e);
+  }
+}
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(RecordAccess& r) {
+  count(r);
+  walk(*r.getSubNode());
+}
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(FunctionCall& f) {
+  count(f);
+  walk(*f.getSubNode());
+  for (auto& e : f.getListParam()) {
+    walk(*e);
+  }
+}
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(Cast& c) {
+  count(c);
+  walk(*c.getSubNode());
+}
+
+// Stmt
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(AssignmentStmt& a) {
+  ++numNode;
+  walk(*a.getSubLeft());
+  walk(*a.getSubRight());
+}
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(FunctionCallStmt& f) {
+  ++numNode;
+  walk(*f.getSubNode());
+}
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(BlockStmt& b) {
+  ++numNode;
+  for (auto& e : b.getBlock()) {
+    walk(*e);
+  }
+}
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(IfStmt& i) {
+  ++numNode;
+  walk(*i.getCondition());
+  walk(*i.getSubThen());
+  if (i.getSubElse() != nullptr) {
+    walk(*i.getSubElse());
+  }
+}
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(WhileStmt& w) {
+  ++numNode;
+  walk(*w.getCondition());
+  walk(*w.getSubNode());
+}
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(ForStmt& f) {
+  ++numNode;
+  walk(*f.getVar());
+  walk(*f.getLow());
+  walk(*f.getHigh());
+  walk(*f.getSubNote());
+}
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(BreakStmt&) { ++numNode; }
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(ContinueStmt&) { ++numNode; }
+
+// Decl
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(Function& f) {
+  visit(f.getTable());
+  walk(*f.getBody());
+}
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(MainFunction& m) {
+  visit(m.getTable());
+  walk(*m.getBody());
+}
+
+template <bool isDispatch>
+void BasicCountVisitor<isDispatch>::visit(Tables& t) {
+  for (auto& e : t.tableFunction) {
+    walk(*e);
+  }
+}
+
+template class BasicCountVisitor<false>;
+template class BasicCountVisitor<true>;
@@ -9,31 +9,69 @@
 #include "../exception.h"
 #include "type_checker.h"
 
+namespace {
+
+enum class Assoc : uint8_t { Left, Right };
+
+// What a token means inside an expression. Infix operators bind with
+// power 1 (relational) to 3 (multiplicative), 0 - not an infix operator.
+// Prefix operators bind tighter than any infix one, postfix access
+// tighter than prefix.
+struct Operator {
+  uint8_t power = 0;
+  Assoc assoc = Assoc::Left;
+  bool isPrefix = false;
+  bool isPostfix = false;
+};
+
+using OperatorTable = std::array<Operator, numTokenType>;
+
+constexpr OperatorTable makeOperatorTable() {
+  OperatorTable t{};
+  auto infix = [&t](TokenType type, uint8_t power) {
+    t[static_cast<int>(type)].power = power;
+    t[static_cast<int>(type)].assoc = Assoc::Left;
+  };
+  for (auto e : {TokenType::StrictLess, TokenType::StrictGreater,
+                 TokenType::NotEquals, TokenType::Equals,
+                 TokenType::LessOrEquals, TokenType::GreaterOrEquals}) {
+    infix(e, 1);
+  }
+  for (auto e : {TokenType::Minus, TokenType::Plus, TokenType::Or, TokenType::Xor}) {
+    infix(e, 2);
+  }
+  for (auto e : {TokenType::Asterisk, TokenType::Slash,
+                 TokenType::Div, TokenType::Mod, TokenType::And,
+                 TokenType::Shr, TokenType::ShiftRight, // TODO: replace one tokenType
+                 TokenType::Shl, TokenType::ShiftLeft}) {
+    infix(e, 3);
+  }
+  for (auto e : {TokenType::Not, TokenType::Minus, TokenType::Plus, TokenType::At}) {
+    t[static_cast<int>(e)].isPrefix = true;
+  }
+  for (auto e : {TokenType::Caret, TokenType::Dot,
+                 TokenType::OpenSquareBracket, TokenType::OpenParenthesis}) {
+    t[static_cast<int>(e)].isPostfix = true;
+  }
+  return t;
+}
+
+constexpr OperatorTable operatorTable = makeOperatorTable();
+
+const Operator& getOperator(const Token& t) {
+  return operatorTable[static_cast<int>(t.getTokenType())];
+}
+
+} // namespace
 
-Parser::Parser(const std::string& s)
-  : lexer(s),
+
+Parser::Parser(const std::string& s, lx::SourceMode mode)
+  : lexer(s, mode),
     semanticDecl() {
   assigment = {TokenType::Assignment, TokenType::AssignmentWithMinus,
                TokenType::AssignmentWithPlus,
                TokenType::AssignmentWithAsterisk,
                TokenType::AssignmentWithSlash};
-  priority[0] = {TokenType::StrictLess, TokenType::StrictGreater,
-                 TokenType::NotEquals, TokenType::Equals,
-                 TokenType::LessOrEquals, TokenType::GreaterOrEquals};
-  priority[1] = {TokenType::Minus, TokenType::Plus,
-                 TokenType::Or, TokenType::Xor};
-  priority[2] = {TokenType::Asterisk, TokenType::Slash,
-                 TokenType::Div, TokenType::Mod,
-                 TokenType::And,
-                 TokenType::Shr, TokenType::ShiftRight, // TODO: replace one tokenType
-                 TokenType::Shl, TokenType::ShiftLeft};
-  priority[3] = {TokenType::Not, TokenType::Minus,
-                 TokenType::Plus, TokenType::At};
-  priorityLeftUnary  = 3;
-  priority[4] = {TokenType::Caret, TokenType::Dot,
-                 TokenType::OpenSquareBracket,
-                 TokenType::OpenParenthesis};
-  priorityAccess = 4;
 }
 
 ptr_Node Parser::parseProgram() {
@@ -85,7 +123,7 @@ ListParam Parser::parseFormalParameterList() {
   ListParam paramList(parseFormalParamSection(paramTable));
   while (match(TokenType::Comma)) {
     ++lexer;
-    paramList.splice(paramList.end(), parseFormalParamSection(paramTable));
+    paramList.append(parseFormalParamSection(paramTable));
   }
   requireAndSkip(TokenType::CloseParenthesis);
   return paramList;
@@ -101,10 +139,10 @@ ptr_Expr Parser::parseFactor() {
     case TokenType::Nil:
     case TokenType::False:
     case TokenType::True: {
-      return std::make_unique<Literal>(token);
+      return makeNode<Literal>(token);
     }
     case TokenType::Id: {
-      return std::make_unique<Variable>(token);
+      return makeNode<Variable>(token);
     }
     case TokenType::OpenParenthesis: {
       auto expr = parseBinaryOperator();
@@ -116,15 +154,15 @@ ptr_Expr Parser::parseFactor() {
   }
 }
 
-ptr_Expr Parser::parseAccess(int p) {
-  auto left = getExprByPriority(p + 1);
+ptr_Expr Parser::parseAccess() {
+  auto left = parseFactor();
 
-  while (match(priority[p])) {
+  while (getOperator(lexer.get()).isPostfix) {
     switch (lexer.get().getTokenType()) {
       case TokenType::Dot: {
         auto d = lexer.next();
         require(TokenType::Id);
-        left = std::make_unique<RecordAccess>(d, std::move(left), lexer.next());
+        left = makeNode<RecordAccess>(d, std::move(left), lexer.next());
         break;
       }
       case TokenType::OpenParenthesis: {
@@ -139,11 +177,11 @@ ptr_Expr Parser::parseAccess(int p) {
         auto d = lexer.next();
         auto list = parseListExpression();
         requireAndSkip(TokenType::CloseSquareBracket);
-        left = std::make_unique<ArrayAccess>(d, std::move(left), std::move(list));
+        left = makeNode<ArrayAccess>(d, std::move(left), std::move(list));
         break;
       }
       case TokenType::Caret: {
-        left = std::make_unique<UnaryOperation>(lexer.next(), std::move(left));
+        left = makeNode<UnaryOperation>(lexer.next(), std::move(left));
         break;
       }
       default:
@@ -154,37 +192,30 @@ ptr_Expr Parser::parseAccess(int p) {
   return left;
 }
 
-ptr_Expr Parser::parseUnaryOperator(int p) {
-  if (!match(priority[p])) {
-      return getExprByPriority(p + 1);
+ptr_Expr Parser::parseUnaryOperator() {
+  if (!getOperator(lexer.get()).isPrefix) {
+    return parseAccess();
   }
   auto op = lexer.next();
-  return std::make_unique<UnaryOperation>(std::move(op), parseUnaryOperator(p));
+  return makeNode<UnaryOperation>(std::move(op), parseUnaryOperator());
 }
 
-ptr_Expr Parser::parseBinaryOperator(int p) {
-  auto left = getExprByPriority(p + 1);
+// precedence climbing: operators weaker than minPower are left to the caller
+ptr_Expr Parser::parseBinaryOperator(int minPower) {
+  auto left = parseUnaryOperator();
 
-  while (match(priority[p])) {
+  while (true) {
+    auto& e = getOperator(lexer.get());
+    if (e.power == 0 || e.power < minPower) {
+      break;
+    }
     auto op = lexer.next();
-    auto right = getExprByPriority(p + 1);
-    left = std::make_unique<BinaryOperation>(std::move(op), std::move(left), std::move(right));
+    auto right = parseBinaryOperator(e.assoc == Assoc::Left ? e.power + 1 : e.power);
+    left = makeNode<BinaryOperation>(std::move(op), std::move(left), std::move(right));
   }
   return left;
 }
 
-ptr_Expr Parser::getExprByPriority(int p) {
-  if (p == priority.size()) {
-    return parseFactor();
-  } else if (p == priorityLeftUnary) {
-    return parseUnaryOperator(p);
-  } else if (p == priorityAccess) {
-    return parseAccess(p);
-  } else {
-    return parseBinaryOperator(p);
-  }
-}
-
 ptr_Stmt Parser::parseStatement() {
   switch (lexer.get().getTokenType()) {
     case TokenType::Begin: {
@@ -203,21 +234,27 @@ ptr_Stmt Parser::parseStatement() {
       auto t = lexer.next();
       if (isInsideLoop) {
         if (t.getTokenType() == TokenType::Break) {
-          return std::make_unique<BreakStmt>();
+          return makeNode<BreakStmt>();
         }
         else {
-          return std::make_unique<ContinueStmt>();
+          return makeNode<ContinueStmt>();
         }
       }
       throw ParserException(t.getLine(), t.getColumn(), t.getString() + " out of cycle");
     }
     default: {
+      // "id :=" is the common statement, skip the expression descent for its target
+      if (match(TokenType::Id) && match(assigment, 1)) {
+        auto left = makeNode<Variable>(lexer.next());
+        auto op = lexer.next();
+        return makeNode<AssignmentStmt>(std::move(op), std::move(left), parseExpression());
+      }
       auto right = parseExpression();
       if (match(assigment)) {
         auto op = lexer.next();
-        return std::make_unique<AssignmentStmt>(std::move(op), std::move(right), parseExpression());
+        return makeNode<AssignmentStmt>(std::move(op), std::move(right), parseExpression());
       }
-      return std::make_unique<FunctionCallStmt>(std::move(right));
+      return makeNode<FunctionCallStmt>(std::move(right));
     }
   }
 }
@@ -231,7 +268,7 @@ ptr_Stmt Parser::parseCompound() {
     ++lexer;
   }
   requireAndSkip(TokenType::End);
-  return std::make_unique<BlockStmt>(std::move(list));
+  return makeNode<BlockStmt>(std::move(list));
 }
 
 ptr_Stmt Parser::parseIf() {
@@ -241,9 +278,9 @@ ptr_Stmt Parser::parseIf() {
   auto then = parseStatement();
   if (match(TokenType::Else)) {
     ++lexer;
-    return std::make_unique<IfStmt>(std::move(cond), std::move(then), parseStatement());
+    return makeNode<IfStmt>(std::move(cond), std::move(then), parseStatement());
   }
-  return std::make_unique<IfStmt>(std::move(cond), std::move(then));
+  return makeNode<IfStmt>(std::move(cond), std::move(then));
 }
 
 ptr_Stmt Parser::parseWhile() {
@@ -254,13 +291,13 @@ ptr_Stmt Parser::parseWhile() {
   isInsideLoop = true;
   auto block = parseStatement();
   isInsideLoop = !isFirstLoop;
-  return std::make_unique<WhileStmt>(std::move(cond), std::move(block));
+  return makeNode<WhileStmt>(std::move(cond), std::move(block));
 }
 
 ptr_Stmt Parser::parseFor() {
   requireAndSkip(TokenType::For);
   require(TokenType::Id);
-  auto var = std::make_unique<Variable>(lexer.next());
+  auto var = makeNode<Variable>(lexer.next());
   requireAndSkip(TokenType::Assignment);
   auto low = parseExpression();
   require({TokenType::To, TokenType::Downto}, "\"to\" or \"downto\"");
@@ -272,11 +309,11 @@ ptr_Stmt Parser::parseFor() {
   isInsideLoop = true;
   auto block = parseStatement();
   isInsideLoop = !isFirstLoop;
-  return std::make_unique<ForStmt>(std::move(var), std::move(low),
+  return makeNode<ForStmt>(std::move(var), std::move(low),
                                    std::move(high), dir, std::move(block));
 }
 
-std::shared_ptr<MainFunction> Parser::parseMainBlock() {
+MainFunction* Parser::parseMainBlock() {
   parseDecl(true);
   auto body = parseCompound();
   requireAndSkip(TokenType::Dot);
@@ -300,13 +337,11 @@ void Parser::parseDecl(bool isMainBlock) {
       }
       case TokenType::Function:
       case TokenType::Procedure: {
-        auto t = lexer.next();
+        auto& t = lexer.get();
         if (!isMainBlock) {
           throw ParserException(t.getLine(), t.getColumn(), toString(t.getTokenType()));
         }
-        bool isP = t.is(TokenType::Procedure);
-        lexer.push_back(std::move(t));
-        parseFunctionDecl(isP);
+        parseFunctionDecl(t.is(TokenType::Procedure));
         break;
       }
       default: {
@@ -495,14 +530,14 @@ ptr_Type Parser::parseParameterType() {
   }
 }
 
-std::shared_ptr<FunctionSignature> Parser::parseFunctionSignature(bool isProcedure) {
+ptr_Sign Parser::parseFunctionSignature(bool isProcedure) {
   ListParam param;
   Token beginDecl(lexer.get());
   if (isProcedure) {
     if (match(TokenType::OpenParenthesis)) {
       param = parseFormalParameterList();
     }
-    return semanticDecl.parseFunctionSignature(beginDecl, std::move(param), std::make_shared<Void>());
+    return semanticDecl.parseFunctionSignature(beginDecl, std::move(param), makeNode<Void>());
   }
   else {
     if (!match(TokenType::Colon)) {
@@ -543,15 +578,15 @@ ListParam Parser::parseFormalParamSection(TableSymbol<ptr_Var>& paramTable) {
   return semanticDecl.parseFormalParamSection(paramTable, paramSpec, std::move(listId), std::move(type));
 }
 
-bool Parser::match(const std::list<TokenType>& listType) {
+bool Parser::match(const std::list<TokenType>& listType, std::size_t lookahead) {
   for (auto& exceptType: listType) {
-    if (match(exceptType)) { return true; }
+    if (match(exceptType, lookahead)) { return true; }
   }
   return false;
 }
 
-bool Parser::match(TokenType t) {
-  return t == lexer.get().getTokenType();
+bool Parser::match(TokenType t, std::size_t lookahead) {
+  return t == lexer.peek(lookahead).getTokenType();
 }
 
 void Parser::require(TokenType type) {
@@ -10,7 +10,7 @@
 
 class Parser {
  public:
-  explicit Parser(const std::string&);
+  explicit Parser(const std::string&, lx::SourceMode = lx::SourceMode::Buffer);
 
   ptr_Node parseProgram();
   ptr_Expr parseExpression();
@@ -18,10 +18,6 @@ class Parser {
 
  private:
   lx::LexerBuffer lexer;
-  // increasing priority for operator
-  std::array<std::list<TokenType>, 5> priority;
-  int priorityLeftUnary;
-  int priorityAccess;
   std::list<TokenType> assigment;
 
   SemanticDecl semanticDecl;
@@ -34,11 +30,9 @@ class Parser {
   ListToken parseListId();
 
   ptr_Expr parseFactor();
-  ptr_Expr parseAccess(int p);
-  ptr_Expr parseUnaryOperator(int p);
-  ptr_Expr parseBinaryOperator(int priority = 0);
-
-  ptr_Expr getExprByPriority(int p = 0);
+  ptr_Expr parseAccess();
+  ptr_Expr parseUnaryOperator();
+  ptr_Expr parseBinaryOperator(int minPower = 1);
 
   ptr_Stmt parseStatement();
   ptr_Stmt parseCompound();
@@ -54,10 +48,10 @@ class Parser {
   std::pair<int, int> parseRangeType();
   ptr_Type parseParameterType();
 
-  std::shared_ptr<FunctionSignature> parseFunctionSignature(bool isProcedure = false);
+  ptr_Sign parseFunctionSignature(bool isProcedure = false);
   ListParam parseFormalParamSection(TableSymbol<ptr_Var>&);
 
-  std::shared_ptr<MainFunction> parseMainBlock();
+  MainFunction* parseMainBlock();
   void parseDecl(bool isMainBlock = false);
   void parseTypeDecl();
   void parseConstDecl();
@@ -68,7 +62,7 @@ class Parser {
 
   void require(TokenType);
   void require(const std::list<TokenType>& listType, const std::string&);
-  bool match(TokenType);
-  bool match(const std::list<TokenType>& listType);
+  bool match(TokenType, std::size_t lookahead = 0);
+  bool match(const std::list<TokenType>& listType, std::size_t lookahead = 0);
   void requireAndSkip(TokenType);
 };
\ No newline at end of file
@@ -340,7 +340,7 @@ void PrintVisitor::visit(TableSymbol<ptr_Var>& t) {
   --depth;
 }
 
-void PrintVisitor::visit(TableSymbol<std::shared_ptr<Const>>& t) {
+void PrintVisitor::visit(TableSymbol<ptr_Const>& t) {
   print("Table Symbol Const");
   ++depth;
   for (auto& e : t) {
@@ -352,7 +352,7 @@ void PrintVisitor::visit(TableSymbol<std::shared_ptr<Const>>& t) {
   --depth;
 }
 
-void PrintVisitor::visit(TableSymbol<std::shared_ptr<SymFun>>& t) {
+void PrintVisitor::visit(TableSymbol<ptr_Fun>& t) {
   print("Table Symbol Function");
   ++depth;
   for (auto& e : t) {
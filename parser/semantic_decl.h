@@ -22,7 +22,7 @@ class SemanticDecl {
   ptr_Type parsePointer(Token declPoint, Token, bool isCanForwardType);
   ptr_Type parseOpenArray(Token declPoint, ptr_Type);
 
-  std::shared_ptr<FunctionSignature>
+  ptr_Sign
   parseFunctionSignature(const Token&, ListParam, ptr_Type returnType);
 
   ListParam parseFormalParamSection(TableSymbol<ptr_Var>&, ParamSpec, ListToken, ptr_Type);
@@ -34,11 +34,11 @@ class SemanticDecl {
   void parseVariableDecl(ListToken, ptr_Type, bool isGlobal);
   void parseVariableDecl(ListToken id, ptr_Type, ptr_Expr, bool isGlobal);
 
-  void parseFunctionForward(const Token& decl, std::shared_ptr<FunctionSignature>);
-  void parseFunctionDeclBegin(std::shared_ptr<FunctionSignature>);
-  void parseFunctionDeclEnd(const Token& decl, std::shared_ptr<FunctionSignature>, ptr_Stmt);
+  void parseFunctionForward(const Token& decl, ptr_Sign);
+  void parseFunctionDeclBegin(ptr_Sign);
+  void parseFunctionDeclEnd(const Token& decl, ptr_Sign, ptr_Stmt);
 
-  std::shared_ptr<MainFunction> parseMainBlock(ptr_Stmt body);
+  MainFunction* parseMainBlock(ptr_Stmt body);
 
  private:
   StackTable stackTable;
@@ -4,7 +4,7 @@
 
 bool LvalueChecker::is(ptr_Expr& e) {
   LvalueChecker checkLvalue;
-  e->accept(checkLvalue);
+  dispatch(checkLvalue, *e);
   return checkLvalue.isLvalue();
 }
 
@@ -16,14 +16,14 @@ void LvalueChecker::visit(FunctionCall& f) { lvalue = false; }
 
 void LvalueChecker::visit(BinaryOperation& f) { lvalue = false; }
 
-void LvalueChecker::visit(ArrayAccess& a) { a.getSubNode()->accept(*this); }
+void LvalueChecker::visit(ArrayAccess& a) { dispatch(*this, *a.getSubNode()); }
 
-void LvalueChecker::visit(RecordAccess& r) { r.getSubNode()->accept(*this); }
+void LvalueChecker::visit(RecordAccess& r) { dispatch(*this, *r.getSubNode()); }
 
 void LvalueChecker::visit(Cast& f) {
-  f.getSubNode()->accept(*this);
+  dispatch(*this, *f.getSubNode());
   lvalue = f.getNodeType()->isPointer() ||
-           (lvalue && f.getNodeType()->equals(f.getSubNode()->getNodeType().get()));
+           (lvalue && f.getNodeType()->equals(f.getSubNode()->getNodeType()));
 }
 
 void LvalueChecker::visit(UnaryOperation& u) {
@@ -52,13 +52,13 @@ void BaseTypeChecker::visit(StaticArray&) { throw SemanticException(errorMes); }
 
 void BaseTypeChecker::visit(OpenArray&) { throw SemanticException(errorMes); }
 
-void BaseTypeChecker::visit(Alias& a) { a.getRefType()->accept(*this); }
+void BaseTypeChecker::visit(Alias& a) { dispatch(*this, *a.getRefType()); }
 
-void BaseTypeChecker::visit(ForwardType& a) { a.getRefType()->accept(*this); }
+void BaseTypeChecker::visit(ForwardType& a) { dispatch(*this, *a.getRefType()); }
 
 void ArrayAccessChecker::make(ArrayAccess& a, ptr_Type& t) {
   ArrayAccessChecker c(a);
-  t->accept(c);
+  dispatch(c, *t);
 }
 
 void ArrayAccessChecker::visit(Pointer& a) {
@@ -67,7 +67,7 @@ void ArrayAccessChecker::visit(Pointer& a) {
     return;
   } else if (sizeBounds > 1) {
     --sizeBounds;
-    a.getPointerBase()->accept(*this);
+    dispatch(*this, *a.getPointerBase());
   } else if (sizeBounds < 1) {
     throw std::logic_error("Check Array Access size bounds < 1");
   }
@@ -80,7 +80,7 @@ void ArrayAccessChecker::visit(StaticArray& s) {
     arrayAccess.setNodeType(s.getRefType());
     return;
   } else if (boundsType > bounds) {
-    auto copy = std::make_shared<StaticArray>(s);
+    auto copy = makeNode<StaticArray>(s);
     for (int i = 0; i < bounds; ++i) {
       copy->getBounds().pop_front();
     }
@@ -91,7 +91,7 @@ void ArrayAccessChecker::visit(StaticArray& s) {
     return;
   } else if (boundsType < bounds) {
     sizeBounds = bounds - boundsType;
-    s.getRefType()->accept(*this);
+    dispatch(*this, *s.getRefType());
   }
 }
 
@@ -101,7 +101,7 @@ void ArrayAccessChecker::visit(OpenArray& o) {
     return;
   } else if (sizeBounds > 1) {
     --sizeBounds;
-    o.getRefType()->accept(*this);
+    dispatch(*this, *o.getRefType());
   } else if (sizeBounds < 1) {
     throw std::logic_error("Check Array Access size bounds < 1");
   }
@@ -109,19 +109,19 @@ void ArrayAccessChecker::visit(OpenArray& o) {
 
 void RecordAccessChecker::make(RecordAccess& r, ptr_Type& t) {
   RecordAccessChecker c(r);
-  t->accept(c);
+  dispatch(c, *t);
 }
 
 void RecordAccessChecker::visit(Record& r) {
-  if (!r.getTable().checkContain(recordAccess.getField().getString())) {
+  if (!r.getTable().checkContain(recordAccess.getField().getAtom())) {
     throw NotDefinedException(recordAccess.getField());
   }
-  recordAccess.setNodeType(r.getTable().find(recordAccess.getField().getString())->getVarType());
+  recordAccess.setNodeType(r.getTable().find(recordAccess.getField().getAtom())->getVarType());
 }
 
 void FunctionCallChecker::make(FunctionCall& f, const ptr_Symbol& s) {
   FunctionCallChecker c(f);
-  s->accept(c);
+  dispatch(c, *s);
 }
 
 
@@ -132,25 +132,23 @@ void FunctionCallChecker::visit(FunctionSignature& s) {
                             " but find " + std::to_string(f.getListParam().size()));
   }
   f.setNodeType(s.getReturnType());
-  auto iterParameter = s.getParamList().begin();
+  auto iterArgument = f.getListParam().begin();
   ListExpr newParam;
-  for (; iterParameter != s.getParamList().end(); ++iterParameter) {
-    auto parameter = *iterParameter;
-    auto argument = std::move(f.getListParam().front());
-    f.getListParam().pop_front();
+  for (auto& parameter : s.getParamList()) {
+    auto argument = *iterArgument++;
     if (parameter->getSpec() == ParamSpec::Var ||
         parameter->getSpec() == ParamSpec::Out) {
       if (!LvalueChecker::is(argument)) {
         throw SemanticException(argument->getDeclPoint(), "Expect lvalue in argument");
       }
     }
-    if (parameter->getVarType()->equalsForCheckArgument(argument->getNodeType().get())) {
+    if (parameter->getVarType()->equalsForCheckArgument(argument->getNodeType())) {
       newParam.push_back(std::move(argument));
       continue;
     }
     if ((parameter->getVarType()->isDouble() && argument->getNodeType()->isInt()) ||
         (parameter->getVarType()->isPurePointer() && argument->getNodeType()->isTypePointer())) {
-      auto newArgument = std::make_unique<Cast>(parameter->getVarType(), std::move(argument));
+      auto newArgument = makeNode<Cast>(parameter->getVarType(), std::move(argument));
       newParam.push_back(std::move(newArgument));
       continue;
     }
@@ -162,7 +160,7 @@ void FunctionCallChecker::visit(FunctionSignature& s) {
 }
 
 void FunctionCallChecker::visit(Read&) {
-  f.setNodeType(std::make_shared<Void>());
+  f.setNodeType(TypeTable::current().getVoid());
   for (auto& e : f.getListParam()) {
     auto& type = e->getNodeType();
     if (!LvalueChecker::is(e)) {
@@ -176,7 +174,7 @@ void FunctionCallChecker::visit(Read&) {
 }
 
 void FunctionCallChecker::visit(Write&) {
-  f.setNodeType(std::make_shared<Void>());
+  f.setNodeType(TypeTable::current().getVoid());
   for (auto& e : f.getListParam()) {
     auto& type = e->getNodeType();
     if (type->isInt() || type->isDouble() || type->isChar() || type->isString() || type->isPointer()) {
@@ -186,20 +184,20 @@ void FunctionCallChecker::visit(Write&) {
   }
 }
 
-void FunctionCallChecker::visit(Chr& c) { c.getSignature()->accept(*this); }
+void FunctionCallChecker::visit(Chr& c) { dispatch(*this, *c.getSignature()); }
 
-void FunctionCallChecker::visit(Ord& c) { c.getSignature()->accept(*this); }
+void FunctionCallChecker::visit(Ord& c) { dispatch(*this, *c.getSignature()); }
 
-void FunctionCallChecker::visit(Prev& c) { c.getSignature()->accept(*this); }
+void FunctionCallChecker::visit(Prev& c) { dispatch(*this, *c.getSignature()); }
 
-void FunctionCallChecker::visit(Succ& c) { c.getSignature()->accept(*this); }
+void FunctionCallChecker::visit(Succ& c) { dispatch(*this, *c.getSignature()); }
 
-void FunctionCallChecker::visit(Trunc& c) { c.getSignature()->accept(*this); }
+void FunctionCallChecker::visit(Trunc& c) { dispatch(*this, *c.getSignature()); }
 
-void FunctionCallChecker::visit(Round& c) { c.getSignature()->accept(*this); }
+void FunctionCallChecker::visit(Round& c) { dispatch(*this, *c.getSignature()); }
 
 void FunctionCallChecker::visit(Exit& c) {
-  f.setNodeType(std::make_shared<Void>());
+  f.setNodeType(TypeTable::current().getVoid());
   if (c.getReturnType()->isVoid()) {
     if (!f.getListParam().empty()) {
       throw SemanticException(f.getDeclPoint(),
@@ -211,7 +209,7 @@ void FunctionCallChecker::visit(Exit& c) {
     throw SemanticException(f.getDeclPoint(),
                             "Expect 1 argument but find " + std::to_string(f.getListParam().size()));
   }
-  if (!f.getListParam().back()->getNodeType()->equalsForCheckArgument(c.getReturnType().get())) {
+  if (!f.getListParam().back()->getNodeType()->equalsForCheckArgument(c.getReturnType())) {
     throw SemanticException(f.getDeclPoint(),
                             "Expect type " + c.getReturnType()->getSymbolName() + "but find" +
                                 f.getListParam().back()->getNodeType()->getSymbolName());
@@ -224,7 +222,7 @@ void FunctionCallChecker::visit(High&) {
   }
   auto& type = f.getListParam().back()->getNodeType();
   if (type->isOpenArray() || type->isStaticArray()) {
-    f.setNodeType(std::make_shared<Int>());
+    f.setNodeType(TypeTable::current().getInt());
     return;
   }
   throw SemanticException(f.getDeclPoint(), "Expect array type but find " + type->getSymbolName());
@@ -236,7 +234,7 @@ void FunctionCallChecker::visit(Low&) {
 }
 
 
-TypeChecker::TypeChecker(StackTable& s) : stackTable(s) {}
+TypeChecker::TypeChecker(StackTable& s) : stackTable(s), types(TypeTable::current()) {}
 
 bool TypeChecker::isImplicitType(ptr_Type& typeLeft, ptr_Type& typeRight) {
   return ((typeRight->isInt() && typeLeft->isDouble()) ||
@@ -249,28 +247,28 @@ void TypeChecker::visit(Literal& l) {
   }
   switch (l.getSubToken().getTokenType()) {
     case TokenType::Int: {
-      l.setNodeType(std::make_shared<Int>());
+      l.setNodeType(types.getInt());
       break;
     }
     case TokenType::Double: {
-      l.setNodeType(std::make_shared<Double>());
+      l.setNodeType(types.getDouble());
       break;
     }
     case TokenType::Nil: {
-      l.setNodeType(std::make_shared<TPointer>());
+      l.setNodeType(types.getTPointer());
       break;
     }
     case TokenType::String: {
       if (l.getSubToken().getString().size() > 1) {
-        l.setNodeType(std::make_shared<String>());
+        l.setNodeType(types.getString());
       } else {
-        l.setNodeType(std::make_shared<Char>());
+        l.setNodeType(types.getChar());
       }
       break;
     }
     case TokenType::False:
     case TokenType::True: {
-      l.setNodeType(std::make_shared<Boolean>());
+      l.setNodeType(types.getBoolean());
       break;
     }
     default:
@@ -283,33 +281,38 @@ void TypeChecker::visit(Variable& v) {
     throw SemanticException(v.getDeclPoint(), "Expect function call");
   }
 
-  if (stackTable.isFunction(v.getSubToken().getString())) {
-    auto f = stackTable.findFunction(v.getSubToken().getString());
+  uint32_t distance = 0;
+  if (stackTable.isFunction(v.getSubToken().getAtom())) {
+    auto f = stackTable.findFunction(v.getSubToken().getAtom(), &distance);
     if (f->isBuildIn()) {
-      v.setEmbeddedFunction(stackTable.findFunction(v.getSubToken().getString()));
+      v.setEmbeddedFunction(f);
       v.setNodeType(nullptr);
       return;
-    } else if (stackTable.top().tableVariable.checkContain(f->getSymbolName()) &&
-               !wasFunctionCall) {
+    } else if (auto result = stackTable.findTop(f->getAtom(), SymbolKind::Variable);
+               result != nullptr && !wasFunctionCall) {
       // for variable result function - foo and foo()
+      v.setSymbol(result, 0);
       v.setNodeType(f->getSignature()->getReturnType());
       return;
     }
-    f->getSignature()->setSymbolName(f->getSymbolName());
+    f->getSignature()->setSymbolName(f->getAtom());
+    v.setSymbol(f, distance);
     v.setNodeType(f->getSignature());
     return;
   }
 
   // TODO const
-  if (stackTable.isConst(v.getSubToken().getString())) {
-    v.setNodeType(stackTable.findConst(v.getSubToken().getString())->getVarType());
+  if (stackTable.isConst(v.getSubToken().getAtom())) {
+    v.setNodeType(stackTable.findConst(v.getSubToken().getAtom())->getVarType());
     return;
   }
 
-  if (!stackTable.isVar(v.getSubToken().getString())) {
+  if (!stackTable.isVar(v.getSubToken().getAtom())) {
     throw NotDefinedException(v.getSubToken());
   }
-  v.setNodeType(stackTable.findVar(v.getSubToken().getString())->getVarType());
+  auto var = stackTable.findVar(v.getSubToken().getAtom(), &distance);
+  v.setSymbol(var, distance);
+  v.setNodeType(var->getVarType());
 }
 
 bool TypeChecker::setCast(BinaryOperation& b, bool isAssigment) {
@@ -317,11 +320,11 @@ bool TypeChecker::setCast(BinaryOperation& b, bool isAssigment) {
   auto& rightType = b.getSubRight()->getNodeType();
 
   if (isImplicitType(leftType, rightType)) {
-    b.setSubRight(std::make_unique<Cast>(leftType, std::move(b.getSubRight())));
+    b.setSubRight(makeNode<Cast>(leftType, std::move(b.getSubRight())));
     b.setNodeType(leftType);
     return true;
   } else if (!isAssigment && isImplicitType(rightType, leftType)) {
-    b.setSubLeft(std::make_unique<Cast>(rightType, std::move(b.getSubLeft())));
+    b.setSubLeft(makeNode<Cast>(rightType, std::move(b.getSubLeft())));
     b.setNodeType(rightType);
     return true;
   }
@@ -347,24 +350,24 @@ bool TypeChecker::checkTypePlusMinus(BinaryOperation& b, bool isAssigment) {
   } else if ((b.getOp().is(TokenType::Minus) ||
 			b.getOp().is(TokenType::AssignmentWithMinus)) &&
              leftType->isPointer() && rightType->isPointer()) {
-    b.setNodeType(std::make_shared<Int>());
+    b.setNodeType(types.getInt());
     return true;
   }
 
-  if (leftType->equals(rightType.get())) {
+  if (leftType->equals(rightType)) {
     b.setNodeType(leftType);
     return true;
   }
 
-  auto m = [](ptr_Expr& r, uint64_t s) -> ptr_Expr {
-    auto c = std::make_unique<BinaryOperation>(
-      Token(-1, -1, TokenType::Asterisk),
+  auto m = [this](ptr_Expr& r, uint64_t s) -> ptr_Expr {
+    auto c = makeNode<BinaryOperation>(
+      Token({}, TokenType::Asterisk),
       std::move(r),
-      std::make_unique<Literal>(
-          Token(-1, -1, s, ""),
-          std::make_shared<Int>())
+      makeNode<Literal>(
+          Token({}, s, ""),
+          types.getInt())
     );
-    c->setNodeType(std::make_unique<Int>());
+    c->setNodeType(types.getInt());
     return c;
   };
 
@@ -387,16 +390,16 @@ bool TypeChecker::checkTypeSlashAsterisk(BinaryOperation& b, bool isAssigment) {
   auto& leftType = b.getSubLeft()->getNodeType();
   auto& rightType = b.getSubRight()->getNodeType();
 
-  bool isPass = (leftType->isDouble() || leftType->isInt()) && leftType->equals(rightType.get());
+  bool isPass = (leftType->isDouble() || leftType->isInt()) && leftType->equals(rightType);
   b.setNodeType(leftType);
   if (b.getOp().is(TokenType::Slash) ||
 			b.getOp().is(TokenType::AssignmentWithSlash)) {
     if (leftType->isInt() && rightType->isInt()) {
       isPass = !isAssigment;
-      b.setSubLeft(std::make_unique<Cast>(std::make_shared<Double>(), std::move(b.getSubLeft())));
-      b.setSubRight(std::make_unique<Cast>(std::make_shared<Double>(), std::move(b.getSubRight())));
+      b.setSubLeft(makeNode<Cast>(types.getDouble(), std::move(b.getSubLeft())));
+      b.setSubRight(makeNode<Cast>(types.getDouble(), std::move(b.getSubRight())));
     }
-    b.setNodeType(std::make_shared<Double>());
+    b.setNodeType(types.getDouble());
   }
   return isPass;
 }
@@ -407,8 +410,8 @@ void TypeChecker::visit(BinaryOperation& b) {
   }
   wasFunctionCall = false;
 
-	b.getSubLeft()->accept(*this);
-	b.getSubRight()->accept(*this);
+	dispatch(*this, *b.getSubLeft());
+	dispatch(*this, *b.getSubRight());
 
   auto& leftType = b.getSubLeft()->getNodeType();
   auto& rightType = b.getSubRight()->getNodeType();
@@ -444,15 +447,15 @@ void TypeChecker::visit(BinaryOperation& b) {
     case TokenType::And:
     case TokenType::Or:
     case TokenType::Xor: {
-      isPass = (leftType->isInt() || leftType->isBool()) && leftType->equals(rightType.get());
+      isPass = (leftType->isInt() || leftType->isBool()) && leftType->equals(rightType);
       b.setNodeType(leftType);
       break;
     }
     case TokenType::Equals:
     case TokenType::NotEquals: {
       if (leftType->isPointer() && rightType->isPointer()) {
-        isPass = setCast(b, false) || leftType->equals(rightType.get());
-        b.setNodeType(std::make_shared<Boolean>());
+        isPass = setCast(b, false) || leftType->equals(rightType);
+        b.setNodeType(types.getBoolean());
         break;
       }
     }
@@ -461,9 +464,9 @@ void TypeChecker::visit(BinaryOperation& b) {
     case TokenType::LessOrEquals:
     case TokenType::GreaterOrEquals: {
       isPass = ((leftType->isInt() || leftType->isDouble() || leftType->isChar()) &&
-                leftType->equals(rightType.get())) ||
+                leftType->equals(rightType)) ||
                setCast(b, false);
-      b.setNodeType(std::make_shared<Boolean>());
+      b.setNodeType(types.getBoolean());
       break;
     }
     default: {
@@ -482,7 +485,7 @@ void TypeChecker::visit(UnaryOperation& u) {
   }
   wasFunctionCall = false;
 
-  u.getSubNode()->accept(*this);
+  dispatch(*this, *u.getSubNode());
   auto& childType = u.getSubNode()->getNodeType();
   if (childType == nullptr) {
     throw SemanticException(u.getDeclPoint(),
@@ -520,8 +523,8 @@ void TypeChecker::visit(UnaryOperation& u) {
         throw SemanticException(u.getDeclPoint(), mesLvalue);
       }
       isPass = true;
-      u.setNodeType(std::make_shared<Pointer>(childType));
-      if (childType->isProcedureType() && stackTable.isFunction(childType->getSymbolName())) {
+      u.setNodeType(makeNode<Pointer>(childType));
+      if (childType->isProcedureType() && stackTable.isFunction(childType->getAtom())) {
         u.setNodeType(childType);
       }
       break;
@@ -545,13 +548,13 @@ void TypeChecker::visit(ArrayAccess& a) {
   if (!LvalueChecker::is(a.getSubNode())) {
     throw SemanticException(a.getSubNode()->getDeclPoint(), "Expect lvalue in []");
   }
-  a.getSubNode()->accept(*this);
+  dispatch(*this, *a.getSubNode());
   if (a.getSubNode()->getNodeType() == nullptr) {
     throw SemanticException(a.getSubNode()->getDeclPoint(), "Cannot [] on function");
   }
 
   for (auto& e : a.getListIndex()) {
-    e->accept(*this);
+    dispatch(*this, *e);
     if (e->getNodeType() == nullptr) {
       throw SemanticException(e->getDeclPoint(), "Function not valid index");
     }
@@ -572,7 +575,7 @@ void TypeChecker::visit(RecordAccess& r) {
   if (!LvalueChecker::is(r.getSubNode())) {
     throw SemanticException(r.getSubNode()->getDeclPoint(), "Expect lvalue in .");
   }
-  r.getSubNode()->accept(*this);
+  dispatch(*this, *r.getSubNode());
   if (r.getSubNode()->getNodeType() == nullptr) {
     throw SemanticException(r.getSubNode()->getDeclPoint(), "Cannot . on function");
   }
@@ -587,10 +590,10 @@ void TypeChecker::visit(FunctionCall& f) {
     throw SemanticException(f.getSubNode()->getDeclPoint(), "Expect lvalue in ()");
   }
   wasFunctionCall = true;
-  f.getSubNode()->accept(*this);
+  dispatch(*this, *f.getSubNode());
   wasFunctionCall = false;
   for (auto& e: f.getListParam()) {
-    e->accept(*this);
+    dispatch(*this, *e);
   }
   if (f.getSubNode()->getEmbeddedFunction() != nullptr) {
     FunctionCallChecker::make(f, f.getSubNode()->getEmbeddedFunction());
@@ -604,14 +607,14 @@ void TypeChecker::visit(Cast& s) {
     throw SemanticException("Expect function call but find cast");
   }
   wasFunctionCall = false;
-  s.getSubNode()->accept(*this);
+  dispatch(*this, *s.getSubNode());
   auto& to = s.getNodeType();
   auto& from = s.getSubNode()->getNodeType();
   auto isPass = [](ptr_Type& to, ptr_Type& from) {
     return (to->isInt() && (from->isInt() || from->isDouble() || from->isBool())) ||
            (to->isDouble() && (from->isInt() || from->isDouble())) ||
            (to->isPurePointer() && (from->isPointer() || from->isPurePointer())) ||
-           (to->isTypePointer() && (from->isPurePointer() || from->equals(to.get())));
+           (to->isTypePointer() && (from->isPurePointer() || from->equals(to)));
   };
 
   if (isPass(to, from)) {
@@ -626,8 +629,8 @@ void TypeChecker::visit(AssignmentStmt& a) {
   if (isMustFunctionCall) {
     throw SemanticException(a.getDeclPoint(), "Expect function call but find assigment");
   }
-	a.getSubLeft()->accept(*this);
-	a.getSubRight()->accept(*this);
+	dispatch(*this, *a.getSubLeft());
+	dispatch(*this, *a.getSubRight());
   if (!LvalueChecker::is(a.getSubLeft())) {
     throw SemanticException(a.getSubLeft()->getDeclPoint(), "Expect lvalue in assigment");
   }
@@ -661,34 +664,34 @@ void TypeChecker::visit(AssignmentStmt& a) {
     }
   }
   if (isImplicitType(typeLeft, typeRight)) {
-    a.setSubRight(std::make_unique<Cast>(typeLeft, std::move(a.getSubRight())));
+    a.setSubRight(makeNode<Cast>(typeLeft, std::move(a.getSubRight())));
     return;
   }
-  if (!typeRight->equals(typeLeft.get())) {
+  if (!typeRight->equals(typeLeft)) {
     throw SemanticException(a.getDeclPoint(), mes);
   }
 }
 
 void TypeChecker::visit(FunctionCallStmt& f) {
   isMustFunctionCall = true;
-  f.getSubNode()->accept(*this);
+  dispatch(*this, *f.getSubNode());
   isMustFunctionCall = false;
 }
 
 void TypeChecker::visit(BlockStmt& b) {
   for (auto& e: b.getBlock()) {
-    e->accept(*this);
+    dispatch(*this, *e);
   }
 }
 
 void TypeChecker::visit(IfStmt& i) {
-  i.getCondition()->accept(*this);
-  i.getSubThen()->accept(*this);
+  dispatch(*this, *i.getCondition());
+  dispatch(*this, *i.getSubThen());
   if (i.getSubElse() != nullptr) {
-    i.getSubElse()->accept(*this);
+    dispatch(*this, *i.getSubElse());
   }
   if (i.getCondition()->getNodeType()->isInt()) {
-    i.setCondition(std::make_unique<Cast>(std::make_shared<Boolean>(), std::move(i.getCondition())));
+    i.setCondition(makeNode<Cast>(types.getBoolean(), std::move(i.getCondition())));
     return;
   }
   if (!i.getCondition()->getNodeType()->isBool()) {
@@ -698,10 +701,10 @@ void TypeChecker::visit(IfStmt& i) {
 }
 
 void TypeChecker::visit(WhileStmt& w) {
-  w.getCondition()->accept(*this);
-  w.getSubNode()->accept(*this);
+  dispatch(*this, *w.getCondition());
+  dispatch(*this, *w.getSubNode());
   if (w.getCondition()->getNodeType()->isInt()) {
-    w.setCondition(std::make_unique<Cast>(std::make_shared<Boolean>(), std::move(w.getCondition())));
+    w.setCondition(makeNode<Cast>(types.getBoolean(), std::move(w.getCondition())));
     return;
   }
   if (!w.getCondition()->getNodeType()->isBool()) {
@@ -711,10 +714,10 @@ void TypeChecker::visit(WhileStmt& w) {
 }
 
 void TypeChecker::visit(ForStmt& f) {
-  f.getVar()->accept(*this);
-  f.getLow()->accept(*this);
-  f.getHigh()->accept(*this);
-  f.getSubNote()->accept(*this);
+  dispatch(*this, *f.getVar());
+  dispatch(*this, *f.getLow());
+  dispatch(*this, *f.getHigh());
+  dispatch(*this, *f.getSubNote());
   if (!(f.getVar()->getNodeType()->isInt() && f.getLow()->getNodeType()->isInt() &&
         f.getHigh()->getNodeType()->isInt())) {
     throw SemanticException(f.getVar()->getDeclPoint(), "Loop variable must be type int");
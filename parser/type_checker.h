@@ -2,9 +2,10 @@
 
 #include "visitor.h"
 #include "symbol_type.h"
+#include "type_table.h"
 
 
-class LvalueChecker : public Visitor {
+class LvalueChecker final : public Visitor {
  public:
   static bool is(ptr_Expr&);
   LvalueChecker() : lvalue(true) {}
@@ -27,6 +28,8 @@ class BaseTypeChecker : public Visitor {
  public:
   BaseTypeChecker(std::string s) : errorMes(std::move(s)) {}
 
+  using Visitor::visit;
+
   void visit(Int&) override;
   void visit(Double&) override;
   void visit(Char&) override;
@@ -46,7 +49,7 @@ class BaseTypeChecker : public Visitor {
   std::string errorMes;
 };
 
-class ArrayAccessChecker : public BaseTypeChecker {
+class ArrayAccessChecker final : public BaseTypeChecker {
  public:
   static void make(ArrayAccess&, ptr_Type&);
 
@@ -56,6 +59,8 @@ class ArrayAccessChecker : public BaseTypeChecker {
     arrayAccess(a),
     sizeBounds(a.getListIndex().size()) {}
 
+  using BaseTypeChecker::visit;
+
   void visit(Pointer&) override;
   void visit(StaticArray&) override;
   void visit(OpenArray&) override;
@@ -65,7 +70,7 @@ class ArrayAccessChecker : public BaseTypeChecker {
   uint64_t sizeBounds;
 };
 
-class RecordAccessChecker : public BaseTypeChecker {
+class RecordAccessChecker final : public BaseTypeChecker {
  public:
   static void make(RecordAccess&, ptr_Type&);
 
@@ -74,19 +79,23 @@ class RecordAccessChecker : public BaseTypeChecker {
                       "Record access to type \"" + a.getSubNode()->getNodeType()->getSymbolName() + "\" not valid"),
       recordAccess(a) {}
 
+  using BaseTypeChecker::visit;
+
   void visit(Record&) override;
 
  private:
   RecordAccess& recordAccess;
 };
 
-class FunctionCallChecker : public BaseTypeChecker {
+class FunctionCallChecker final : public BaseTypeChecker {
  public:
   static void make(FunctionCall&, const ptr_Symbol&);
 
   FunctionCallChecker(FunctionCall& f)
     : BaseTypeChecker(getPoint(f.getDeclPoint()) + "Expect function or procedure"), f(f) {}
 
+  using BaseTypeChecker::visit;
+
   void visit(FunctionSignature& f) override;
   void visit(Read&) override;
   void visit(Write&) override;
@@ -104,10 +113,12 @@ class FunctionCallChecker : public BaseTypeChecker {
   FunctionCall& f;
 };
 
-class TypeChecker : public Visitor {
+class TypeChecker final : public Visitor {
  public:
   TypeChecker(StackTable& s);
 
+  using Visitor::visit;
+
   void visit(Literal&) override;
   void visit(Variable&) override;
   void visit(BinaryOperation&) override;
@@ -126,6 +137,7 @@ class TypeChecker : public Visitor {
 
  private:
   StackTable& stackTable;
+  TypeTable& types;
   bool isMustFunctionCall = false;
   bool wasFunctionCall = false;
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <fstream>
+#include <vector>
 
 #include "node.h"
 #include "table_symbol.h"
@@ -66,13 +67,88 @@ class Visitor {
   virtual void visit(Low&) {};
   virtual void visit(Exit& e) {};
 
-  virtual void visit(TableSymbol<std::shared_ptr<SymType>>&) {};
-  virtual void visit(TableSymbol<std::shared_ptr<SymVar>>&) {};
-  virtual void visit(TableSymbol<std::shared_ptr<Const>>&) {};
-  virtual void visit(TableSymbol<std::shared_ptr<SymFun>>&) {};
+  virtual void visit(TableSymbol<ptr_Type>&) {};
+  virtual void visit(TableSymbol<ptr_Var>&) {};
+  virtual void visit(TableSymbol<ptr_Const>&) {};
+  virtual void visit(TableSymbol<ptr_Fun>&) {};
   virtual void visit(Tables&) {};
 };
 
+// Calls v.visit with the concrete class of the node, found by a switch on
+// its kind. With a final visitor the call is direct and can be inlined,
+// accept() pays two virtual calls instead. The visitor brings the visit
+// overloads it does not override with "using Visitor::visit".
+template <class V>
+void dispatch(V& v, Expression& e) {
+  switch (e.getKind()) {
+    case NodeKind::Variable: return v.visit(static_cast<Variable&>(e));
+    case NodeKind::Literal: return v.visit(static_cast<Literal&>(e));
+    case NodeKind::BinaryOperation: return v.visit(static_cast<BinaryOperation&>(e));
+    case NodeKind::UnaryOperation: return v.visit(static_cast<UnaryOperation&>(e));
+    case NodeKind::ArrayAccess: return v.visit(static_cast<ArrayAccess&>(e));
+    case NodeKind::RecordAccess: return v.visit(static_cast<RecordAccess&>(e));
+    case NodeKind::FunctionCall: return v.visit(static_cast<FunctionCall&>(e));
+    case NodeKind::Cast: return v.visit(static_cast<Cast&>(e));
+    default: throw std::logic_error("Not an expression kind");
+  }
+}
+
+template <class V>
+void dispatch(V& v, ASTNodeStmt& s) {
+  switch (s.getKind()) {
+    case NodeKind::AssignmentStmt: return v.visit(static_cast<AssignmentStmt&>(s));
+    case NodeKind::FunctionCallStmt: return v.visit(static_cast<FunctionCallStmt&>(s));
+    case NodeKind::BlockStmt: return v.visit(static_cast<BlockStmt&>(s));
+    case NodeKind::IfStmt: return v.visit(static_cast<IfStmt&>(s));
+    case NodeKind::WhileStmt: return v.visit(static_cast<WhileStmt&>(s));
+    case NodeKind::ForStmt: return v.visit(static_cast<ForStmt&>(s));
+    case NodeKind::BreakStmt: return v.visit(static_cast<BreakStmt&>(s));
+    case NodeKind::ContinueStmt: return v.visit(static_cast<ContinueStmt&>(s));
+    default: throw std::logic_error("Not a statement kind");
+  }
+}
+
+template <class V>
+void dispatch(V& v, Symbol& s) {
+  switch (s.getKind()) {
+    case NodeKind::Int: return v.visit(static_cast<Int&>(s));
+    case NodeKind::Double: return v.visit(static_cast<Double&>(s));
+    case NodeKind::Char: return v.visit(static_cast<Char&>(s));
+    case NodeKind::Boolean: return v.visit(static_cast<Boolean&>(s));
+    case NodeKind::TPointer: return v.visit(static_cast<TPointer&>(s));
+    case NodeKind::String: return v.visit(static_cast<String&>(s));
+    case NodeKind::Void: return v.visit(static_cast<Void&>(s));
+    case NodeKind::Alias: return v.visit(static_cast<Alias&>(s));
+    case NodeKind::ForwardType: return v.visit(static_cast<ForwardType&>(s));
+    case NodeKind::Pointer: return v.visit(static_cast<Pointer&>(s));
+    case NodeKind::StaticArray: return v.visit(static_cast<StaticArray&>(s));
+    case NodeKind::OpenArray: return v.visit(static_cast<OpenArray&>(s));
+    case NodeKind::Record: return v.visit(static_cast<Record&>(s));
+    case NodeKind::FunctionSignature: return v.visit(static_cast<FunctionSignature&>(s));
+
+    case NodeKind::LocalVar: return v.visit(static_cast<LocalVar&>(s));
+    case NodeKind::GlobalVar: return v.visit(static_cast<GlobalVar&>(s));
+    case NodeKind::ParamVar: return v.visit(static_cast<ParamVar&>(s));
+    case NodeKind::Const: return v.visit(static_cast<Const&>(s));
+
+    case NodeKind::ForwardFunction: return v.visit(static_cast<ForwardFunction&>(s));
+    case NodeKind::Function: return v.visit(static_cast<Function&>(s));
+    case NodeKind::MainFunction: return v.visit(static_cast<MainFunction&>(s));
+    case NodeKind::Read: return v.visit(static_cast<Read&>(s));
+    case NodeKind::Write: return v.visit(static_cast<Write&>(s));
+    case NodeKind::Trunc: return v.visit(static_cast<Trunc&>(s));
+    case NodeKind::Round: return v.visit(static_cast<Round&>(s));
+    case NodeKind::Succ: return v.visit(static_cast<Succ&>(s));
+    case NodeKind::Prev: return v.visit(static_cast<Prev&>(s));
+    case NodeKind::Chr: return v.visit(static_cast<Chr&>(s));
+    case NodeKind::Ord: return v.visit(static_cast<Ord&>(s));
+    case NodeKind::High: return v.visit(static_cast<High&>(s));
+    case NodeKind::Low: return v.visit(static_cast<Low&>(s));
+    case NodeKind::Exit: return v.visit(static_cast<Exit&>(s));
+    default: throw std::logic_error("Not a symbol kind");
+  }
+}
+
 class PrintVisitor : public Visitor {
  public:
   explicit PrintVisitor(const std::string& out);
@@ -131,10 +207,10 @@ class PrintVisitor : public Visitor {
   void visit(Low&) override;
   void visit(Exit&) override;
 
-  void visit(TableSymbol<std::shared_ptr<SymType>>&) override;
-  void visit(TableSymbol<std::shared_ptr<SymVar>>&) override;
-  void visit(TableSymbol<std::shared_ptr<Const>>&) override;
-  void visit(TableSymbol<std::shared_ptr<SymFun>>&) override;
+  void visit(TableSymbol<ptr_Type>&) override;
+  void visit(TableSymbol<ptr_Var>&) override;
+  void visit(TableSymbol<ptr_Const>&) override;
+  void visit(TableSymbol<ptr_Fun>&) override;
   void visit(Tables&) override;
 
  private:
@@ -142,4 +218,62 @@ class PrintVisitor : public Visitor {
   int depth;
   void print(const std::string&);
   void print(const ptr_Type&);
-};
\ No newline at end of file
+};
+
+// Walks statements and expressions of the program and of every function,
+// the traversal a code generator does, without producing anything. Goes
+// through accept() or, with isDispatch, through dispatch(). Given a vector,
+// also collects the type of every expression.
+template <bool isDispatch>
+class BasicCountVisitor final : public Visitor {
+ public:
+  using Visitor::visit;
+  explicit BasicCountVisitor(std::vector<ptr_Type>* types = nullptr) : types(types) {}
+
+  void visit(Variable&) override;
+  void visit(Literal&) override;
+  void visit(BinaryOperation&) override;
+  void visit(UnaryOperation&) override;
+  void visit(ArrayAccess&) override;
+  void visit(RecordAccess&) override;
+  void visit(FunctionCall&) override;
+  void visit(Cast&) override;
+
+  void visit(AssignmentStmt&) override;
+  void visit(FunctionCallStmt&) override;
+  void visit(BlockStmt&) override;
+  void visit(IfStmt&) override;
+  void visit(WhileStmt&) override;
+  void visit(ForStmt&) override;
+  void visit(BreakStmt&) override;
+  void visit(ContinueStmt&) override;
+
+  void visit(Function&) override;
+  void visit(MainFunction&) override;
+  void visit(Tables&) override;
+
+  uint64_t getNumNode() const { return numNode; }
+
+ private:
+  uint64_t numNode = 0;
+  std::vector<ptr_Type>* types;
+
+  void count(Expression& e) {
+    ++numNode;
+    if (types != nullptr && e.getNodeType() != nullptr) {
+      types->push_back(e.getNodeType());
+    }
+  }
+
+  template <class N>
+  void walk(N& n) {
+    if constexpr (isDispatch) {
+      dispatch(*this, n);
+    } else {
+      n.accept(*this);
+    }
+  }
+};
+
+using CountVisitor = BasicCountVisitor<false>;
+using DispatchCountVisitor = BasicCountVisitor<true>;
@@ -0,0 +1,216 @@
+import os
+import glob
+import subprocess
+import argparse
+import tempfile
+import random
+
+testsPath = os.path.dirname(os.path.abspath(__file__))
+
+cmakeDir = 'cmake-build-debug'
+programName = 'Compile'
+compilePath = testsPath + os.sep + '..' + os.sep + cmakeDir + os.sep + programName
+
+lexPath = testsPath + os.sep + 'lexer'
+asmPath = testsPath + os.sep + 'asm'
+
+
+def validInputs(dirPath):
+	inputFiles = []
+	for finput in sorted(glob.glob(dirPath + os.sep + '*.in')):
+		with open(os.path.splitext(finput)[0] + '.ans') as f:
+			if 'Error' not in f.read():
+				inputFiles.append(finput)
+	return inputFiles
+
+
+def makeCorpus(inputFiles, sizeMb):
+	parts = []
+	for finput in inputFiles:
+		with open(finput) as f:
+			parts.append(f.read() + '\n')
+	chunk = ''.join(parts)
+	repeat = max(1, sizeMb * 1024 * 1024 // len(chunk))
+	corpus = tempfile.NamedTemporaryFile('w', suffix='.in', delete=False)
+	corpus.write(chunk * repeat)
+	corpus.close()
+	return corpus.name
+
+
+def makeLiteralCorpus(sizeMb):
+	rnd = random.Random(1)
+	literals = [
+		lambda: str(rnd.getrandbits(rnd.choice([8, 16, 32, 62]))),
+		lambda: '$' + format(rnd.getrandbits(rnd.choice([8, 16, 32, 62])), 'X'),
+		lambda: '&' + format(rnd.getrandbits(rnd.choice([6, 12, 24])), 'o'),
+		lambda: '%' + format(rnd.getrandbits(rnd.choice([4, 8, 16])), 'b'),
+		lambda: '{}.{}'.format(rnd.getrandbits(20), rnd.getrandbits(16)),
+		lambda: '{}.{}e{}'.format(rnd.getrandbits(8), rnd.getrandbits(12), rnd.randint(-30, 30)),
+		lambda: "#{}#${:x}".format(rnd.randint(32, 126), rnd.randint(32, 126)),
+	]
+	lines = ['const']
+	size = 0
+	i = 0
+	while size < sizeMb * 1024 * 1024:
+		row = ', '.join(rnd.choice(literals)() for _ in range(16))
+		line = '  t{} : array[1..16] of integer = ({});'.format(i, row)
+		lines.append(line)
+		size += len(line) + 1
+		i += 1
+	corpus = tempfile.NamedTemporaryFile('w', suffix='.in', delete=False)
+	corpus.write('\n'.join(lines) + '\n')
+	corpus.close()
+	return corpus.name
+
+
+def makeExpressionCorpus(sizeMb):
+	rnd = random.Random(1)
+	operands = ['a', 'b', 'x1', '12', '3.5', '$FF', 'p^', 'r.f', 'arr[i, j]', 'f(a, b)']
+	operators = ['+', '-', '*', '/', 'div', 'mod', 'and', 'or', 'shl', '<', '<>', '>=']
+
+	def term(depth):
+		if depth > 0 and rnd.random() < 0.2:
+			return '(' + ' '.join(expression(depth - 1)) + ')'
+		return rnd.choice(['', '', '', '-', 'not ']) + rnd.choice(operands)
+
+	def expression(depth):
+		parts = [term(depth)]
+		for _ in range(rnd.randint(1, 4)):
+			parts += [rnd.choice(operators), term(depth)]
+		return parts
+
+	parts = [term(3)]
+	size = 0
+	while size < sizeMb * 1024 * 1024:
+		line = ' '.join([rnd.choice(operators)] + expression(3))
+		parts.append(line)
+		size += len(line) + 1
+	corpus = tempfile.NamedTemporaryFile('w', suffix='.in', delete=False)
+	corpus.write('\n'.join(parts) + '\n')
+	corpus.close()
+	return corpus.name
+
+
+def makeProgramCorpus(sizeMb):
+	head = [
+		'type TRec = record a, b: integer; c: double; end;',
+		'var grid : array [1..8, 1..8] of integer;',
+		'var r : TRec;',
+		'var total : integer;',
+		'',
+	]
+	unit = """function Func{0}(x, y, z : integer) : integer;
+var a, b : integer;
+begin
+    a := x + y * z - (x div 3);
+    b := grid[x mod 8 + 1, y mod 8 + 1] + r.a;
+    if a > b then
+        Func{0} := a - b
+    else
+        Func{0} := b - a;
+end;
+
+procedure Proc{0}(x, y : integer, var s : integer);
+var a, b, c : integer;
+begin
+    a := Func{0}(x, y, x + y);
+    for b := 1 to 8 do begin
+        for c := 1 to 8 do
+            grid[b, c] := grid[c, b] + a * b - c;
+        r.a := r.a + grid[b, 1];
+    end;
+    while a > 0 do begin
+        a := a - 17;
+        s := s + Func{0}(a, b, c);
+    end;
+    writeln(a, ' ', b, ' ', c, ' ', s);
+end;
+
+"""
+	parts = head[:]
+	size = 0
+	i = 0
+	while size < sizeMb * 1024 * 1024:
+		text = unit.format(i)
+		parts.append(text)
+		size += len(text)
+		i += 1
+	parts.append('begin')
+	for k in range(0, i, max(1, i // 64)):
+		parts.append('    Proc{}(total, {}, total);'.format(k, k))
+	parts.append('end.')
+	corpus = tempfile.NamedTemporaryFile('w', suffix='.in', delete=False)
+	corpus.write('\n'.join(parts) + '\n')
+	corpus.close()
+	return corpus.name
+
+
+def runBench(program, corpus, options, runs):
+	for _ in range(runs):
+		result = subprocess.run([program, '-i', corpus, '-b'] + options,
+								stdout=subprocess.PIPE, universal_newlines=True)
+		print(result.stdout.strip())
+
+
+def runPeephole(program, options):
+	names = []
+	removed = {}
+	output = tempfile.NamedTemporaryFile(suffix='.asm', delete=False)
+	output.close()
+	for finput in sorted(glob.glob(asmPath + os.sep + '*.in')):
+		result = subprocess.run([program, '-i', finput, '-o', output.name, '-a', '-O1', '--stats'] + options,
+								stdout=subprocess.PIPE, universal_newlines=True)
+		for line in result.stdout.splitlines():
+			if line.startswith('peephole '):
+				name, count = line[len('peephole '):].rsplit(': ', 1)
+				if name not in removed:
+					names.append(name)
+					removed[name] = 0
+				removed[name] += int(count)
+	os.remove(output.name)
+	for name in names:
+		print('{}: {}'.format(name, removed[name]))
+
+
+if __name__ == '__main__':
+
+	argsParser = argparse.ArgumentParser()
+
+	argsParser.add_argument('-l', '--lexer', help='Tokens per second on the lexer tests', action='store_true')
+	argsParser.add_argument('--literals', help='Tokens per second on a generated table of numeric constants', action='store_true')
+	argsParser.add_argument('-e', '--expression', help='Parse one long generated expression, nodes per second', action='store_true')
+	argsParser.add_argument('-t', '--traversal', help='Parse a generated program and walk its tree, nodes per second', action='store_true')
+	argsParser.add_argument('--peephole', help='Instructions each peephole pattern removes from the asm tests', action='store_true')
+	argsParser.add_argument('-s', '--stream', help='Read source through std::ifstream', action='store_true')
+	argsParser.add_argument('--size', help='Corpus size in megabytes', type=int, default=16)
+	argsParser.add_argument('--runs', help='Number of runs', type=int, default=3)
+	argsParser.add_argument('--program', help='Path to Compile', default=compilePath)
+
+	args = argsParser.parse_args()
+	extra = ['-s'] if args.stream else []
+
+	if args.lexer:
+		corpus = makeCorpus(validInputs(lexPath), args.size)
+		runBench(args.program, corpus, ['-l'] + extra, args.runs)
+		os.remove(corpus)
+
+	if args.literals:
+		corpus = makeLiteralCorpus(args.size)
+		runBench(args.program, corpus, ['-l'] + extra, args.runs)
+		os.remove(corpus)
+
+	if args.traversal:
+		corpus = makeProgramCorpus(args.size)
+		runBench(args.program, corpus, ['-p'] + extra, args.runs)
+		os.remove(corpus)
+
+	if args.expression:
+		corpus = makeExpressionCorpus(args.size)
+		runBench(args.program, corpus, ['-e'] + extra, args.runs)
+		os.remove(corpus)
+
+	if args.peephole:
+		print('stack generator')
+		runPeephole(args.program, [])
+		print('ir')
+		runPeephole(args.program, ['--ir-backend'])
@@ -0,0 +1,75 @@
+#include "atom.h"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+// Safe to intern from several lexer threads. Spellings sit in fixed
+// blocks that never move, so str() reads them without taking the lock.
+struct AtomTable {
+  static constexpr uint32_t blockBits = 12;
+  static constexpr uint32_t blockSize = 1 << blockBits;
+  static constexpr uint32_t maxBlock = 1 << 12;
+
+  AtomTable() {
+    add(std::string_view());
+  }
+
+  const std::string& name(uint32_t id) const {
+    return blocks[id >> blockBits][id & (blockSize - 1)];
+  }
+
+  uint32_t add(std::string_view s) {
+    auto id = count;
+    if ((id >> blockBits) == maxBlock) {
+      throw std::length_error("Too many identifiers");
+    }
+    auto& block = blocks[id >> blockBits];
+    if (!block) {
+      block = std::make_unique<std::string[]>(blockSize);
+    }
+    auto& str = block[id & (blockSize - 1)];
+    str = s;
+    ids.emplace(str, id);
+    ++count;
+    return id;
+  }
+
+  std::shared_mutex mutex;
+  std::array<std::unique_ptr<std::string[]>, maxBlock> blocks;
+  uint32_t count = 0;
+  std::unordered_map<std::string_view, uint32_t> ids;
+};
+
+AtomTable& atomTable() {
+  static AtomTable table;
+  return table;
+}
+
+} // namespace
+
+Atom intern(std::string_view s) {
+  auto& table = atomTable();
+  {
+    std::shared_lock<std::shared_mutex> lock(table.mutex);
+    auto it = table.ids.find(s);
+    if (it != table.ids.end()) {
+      return Atom(it->second);
+    }
+  }
+  std::unique_lock<std::shared_mutex> lock(table.mutex);
+  auto it = table.ids.find(s);
+  if (it != table.ids.end()) {
+    return Atom(it->second);
+  }
+  return Atom(table.add(s));
+}
+
+const std::string& Atom::str() const {
+  return atomTable().name(id);
+}
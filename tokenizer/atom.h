@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// Dense id of an interned identifier spelling, equal atoms have equal
+// spellings. Atom() is the empty name of anonymous symbols.
+class Atom {
+ public:
+  Atom() = default;
+
+  uint32_t getId() const { return id; }
+  const std::string& str() const;
+
+  bool operator==(Atom a) const { return id == a.id; }
+  bool operator!=(Atom a) const { return id != a.id; }
+
+ private:
+  explicit Atom(uint32_t id) : id(id) {}
+  friend Atom intern(std::string_view);
+
+  uint32_t id = 0;
+};
+
+// process wide pool, spellings are never released; thread safe
+Atom intern(std::string_view);
+
+namespace std {
+template <>
+struct hash<Atom> {
+  size_t operator()(Atom a) const noexcept { return a.getId(); }
+};
+} // namespace std
@@ -0,0 +1,68 @@
+#include "compact_token.h"
+
+using namespace lx;
+
+void TokenTable::clear() {
+  tokens.clear();
+  ints.clear();
+  doubles.clear();
+  atoms.clear();
+  strings.clear();
+}
+
+void TokenTable::push(const Token& t, const char* sourceBegin) {
+  auto lexeme = t.getStrValue();
+  CompactToken c{static_cast<uint32_t>(lexeme.data() - sourceBegin),
+                 static_cast<uint32_t>(lexeme.size()), 0, t.getTokenType()};
+  switch (c.kind) {
+    case TokenType::Int: {
+      c.payload = ints.size();
+      ints.push_back(t.getInt());
+      break;
+    }
+    case TokenType::Double: {
+      c.payload = doubles.size();
+      doubles.push_back(t.getDouble());
+      break;
+    }
+    case TokenType::Id: {
+      c.payload = atoms.size();
+      atoms.push_back(t.getAtom());
+      break;
+    }
+    default: {
+      auto value = t.getStringView();
+      if (value.data() == lexeme.data() && value.size() == lexeme.size()) {
+        c.payload = valueIsLexeme;
+      } else if (value.data() == getSpelling(c.kind).data()) {
+        c.payload = valueIsSpelling;
+      } else {
+        c.payload = strings.size();
+        strings.push_back(value);
+      }
+    }
+  }
+  tokens.push_back(c);
+}
+
+Token TokenTable::expand(const CompactToken& c, const char* sourceBegin, const LineTable& lines) const {
+  std::string_view lexeme(sourceBegin + c.offset, c.length);
+  SourcePoint point(lines, c.offset);
+  switch (c.kind) {
+    case TokenType::Int: {
+      return Token(point, ints[c.payload], lexeme);
+    }
+    case TokenType::Double: {
+      return Token(point, doubles[c.payload], lexeme);
+    }
+    case TokenType::Id: {
+      return Token(point, atoms[c.payload], lexeme);
+    }
+    default: {
+      auto value = c.payload == valueIsLexeme ? lexeme
+                 : c.payload == valueIsSpelling ? getSpelling(c.kind)
+                 : strings[c.payload];
+      return Token(point, c.kind, value, lexeme);
+    }
+  }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "atom.h"
+#include "line_table.h"
+#include "token.h"
+
+namespace lx {
+
+// 16 byte token for bulk storage. The lexeme is source[offset, offset + length),
+// payload indexes the value table of the kind, line and column are looked up
+// in the LineTable of the source.
+struct CompactToken {
+  uint32_t offset;
+  uint32_t length;
+  uint32_t payload;
+  TokenType kind;
+
+  std::size_t end() const { return std::size_t(offset) + length; }
+};
+
+static_assert(sizeof(CompactToken) == 16, "CompactToken should stay 16 bytes");
+
+// Tokens lexed from one source buffer together with their values
+class TokenTable {
+ public:
+  void reserve(std::size_t n) { tokens.reserve(n); }
+  void clear();
+  // t must view the buffer that starts at sourceBegin
+  void push(const Token& t, const char* sourceBegin);
+
+  std::size_t size() const { return tokens.size(); }
+  const CompactToken& operator[](std::size_t i) const { return tokens[i]; }
+  auto begin() const { return tokens.begin(); }
+  auto end() const { return tokens.end(); }
+
+  Token expand(const CompactToken&, const char* sourceBegin, const LineTable&) const;
+
+ private:
+  static constexpr uint32_t valueIsLexeme = UINT32_MAX;
+  static constexpr uint32_t valueIsSpelling = UINT32_MAX - 1;
+
+  std::vector<CompactToken> tokens;
+  std::vector<uint64_t> ints;
+  std::vector<long double> doubles;
+  std::vector<Atom> atoms;
+  std::vector<std::string_view> strings;
+};
+
+} // namespace lx
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "token_type.h"
+
+// Perfect hash over KEYWORD_TYPE: the key is built from the raw bytes of
+// the identifier folded to lower case, a multiplier picked at compile time
+// sends every keyword to its own slot, so a lookup is one probe and one
+// compare.
+
+namespace lx {
+namespace keyword {
+
+struct Entry {
+  std::string_view name;
+  TokenType type = TokenType::Id;
+};
+
+#define MAKE_ENTRY(E, S) Entry{S, TokenType::E},
+inline constexpr Entry list[] = {KEYWORD_TYPE(MAKE_ENTRY)};
+#undef MAKE_ENTRY
+
+constexpr int bits = 8;
+constexpr int numSlot = 1 << bits;
+
+// identifier bytes are letters, digits and '_', only letters change
+constexpr uint32_t fold(char c) { return static_cast<uint8_t>(c) | 0x20u; }
+
+constexpr uint32_t key(std::string_view s) {
+  return fold(s[0]) | fold(s[1]) << 8 | fold(s.back()) << 16 | static_cast<uint32_t>(s.size()) << 24;
+}
+
+constexpr uint32_t slot(uint32_t key, uint32_t seed) {
+  return (key * seed) >> (32 - bits);
+}
+
+constexpr std::size_t minLength() {
+  std::size_t r = list[0].name.size();
+  for (auto& e : list) {
+    r = e.name.size() < r ? e.name.size() : r;
+  }
+  return r;
+}
+
+constexpr std::size_t maxLength() {
+  std::size_t r = 0;
+  for (auto& e : list) {
+    r = e.name.size() > r ? e.name.size() : r;
+  }
+  return r;
+}
+
+constexpr uint32_t findSeed() {
+  for (uint32_t seed = 0x9E3779B1u, i = 0; i < 100000; seed += 2, ++i) {
+    bool used[numSlot] = {};
+    bool isPerfect = true;
+    for (auto& e : list) {
+      auto h = slot(key(e.name), seed);
+      isPerfect &= !used[h];
+      used[h] = true;
+    }
+    if (isPerfect) {
+      return seed;
+    }
+  }
+  return 0;
+}
+
+inline constexpr std::size_t minLen = minLength();
+inline constexpr std::size_t maxLen = maxLength();
+inline constexpr uint32_t seed = findSeed();
+
+static_assert(minLen >= 2, "key reads two leading bytes");
+static_assert(seed != 0, "no perfect multiplier for keyword list");
+
+constexpr std::array<Entry, numSlot> makeTable() {
+  std::array<Entry, numSlot> t{};
+  for (auto& e : list) {
+    t[slot(key(e.name), seed)] = e;
+  }
+  return t;
+}
+
+inline constexpr std::array<Entry, numSlot> table = makeTable();
+
+// TokenType of the keyword spelled by s in any case, Id otherwise
+constexpr TokenType find(std::string_view s) {
+  if (s.size() < minLen || s.size() > maxLen) {
+    return TokenType::Id;
+  }
+  auto& e = table[slot(key(s), seed)];
+  if (e.name.size() != s.size()) {
+    return TokenType::Id;
+  }
+  for (std::size_t i = 0; i < s.size(); ++i) {
+    if (fold(s[i]) != static_cast<uint8_t>(e.name[i])) {
+      return TokenType::Id;
+    }
+  }
+  return e.type;
+}
+
+static_assert(find("BeGiN") == TokenType::Begin && find("begins") == TokenType::Id,
+              "keyword lookup must be case insensitive and exact");
+
+} // namespace keyword
+} // namespace lx
@@ -1,6 +1,9 @@
 #include <algorithm>
+#include <limits>
 #include <iostream>
 #include "lexer.h"
+#include "keyword_table.h"
+#include "literal.h"
 
 #include "token_type.h"
 #include "../exception.h"
@@ -8,28 +11,82 @@
 
 using namespace lx;
 
-Lexer::Lexer(const std::string& filename)
-  : line(1), column(1),
-    readFile(filename, std::ifstream::in) {}
+Lexer::Lexer(const std::string& filename, SourceMode m)
+  : line(1), column(1), mode(m) {
+  if (mode == SourceMode::Stream) {
+    readFile.open(filename, std::ifstream::in);
+    countActions = table::NewLine | table::NextColumn;
+  } else {
+    source = SourceBuffer(filename);
+    sourceBegin = cursor = source.begin();
+    sourceEnd = source.end();
+    ownLines = LineTable(source.begin(), source.end());
+    scanRun = selectScanner();
+  }
+}
+
+Lexer::Lexer(const SourceBuffer& buffer, const LineTable& lines, const char* start)
+  : line(1), column(1), mode(SourceMode::Buffer),
+    sourceBegin(buffer.begin()), cursor(start), sourceEnd(buffer.end()),
+    sharedLines(&lines), scanRun(selectScanner()) {}
+
+Position Lexer::locate(const char* p) {
+  auto& lines = sharedLines ? *sharedLines : ownLines;
+  return lines.locate(p - sourceBegin);
+}
+
+// where the counters of stream mode put the token: its first byte,
+// for a token without lexeme the byte just read or the end of file;
+// a buffer token keeps the offset, the line table resolves it on demand
+SourcePoint Lexer::tokenPoint() {
+  if (mode == SourceMode::Stream) {
+    return {line, beginToken};
+  }
+  auto p = lexemeLength > 0 ? lexemeBegin : isEndSource ? cursor : cursor - 1;
+  return {sharedLines ? *sharedLines : ownLines, static_cast<std::size_t>(p - sourceBegin)};
+}
+
+Position Lexer::tokenStart() {
+  return tokenPoint().get();
+}
+
+// position after the symbol just read, '\n' that ends a token
+// and the end of file do not move to the next line
+Position Lexer::symbolPosition() {
+  if (mode == SourceMode::Stream) {
+    return {line, numSymbol};
+  }
+  if (isEndSource) {
+    auto p = locate(cursor);
+    ++p.column;
+    return p;
+  }
+  return locate(curSymbol == '\n' ? cursor - 1 : cursor);
+}
 
     // TODO rename error message
 void Lexer::errorHandler(int state) {
   std::string c(1, curSymbol);
   switch (state) {
     case (-77): {
-      throw LexerException(line, beginToken, "Error: Illegal character \"" + c + "\"");
+      auto at = tokenStart();
+      throw LexerException(at.line, at.column, "Error: Illegal character \"" + c + "\"");
     }
     case (-71): {
-      throw LexerException(line, beginToken, "Error: String on new line");
+      auto at = tokenStart();
+      throw LexerException(at.line, at.column, "Error: String on new line");
     }
     case (-80): {
-      throw LexerException(line, beginToken + 1, "Error: Illegal start integer constant \"" + c + "\"");
+      auto at = tokenStart();
+      throw LexerException(at.line, at.column + 1, "Error: Illegal start integer constant \"" + c + "\"");
     }
     case (-81): {
-      throw LexerException(line, numSymbol - 1, "Error: Illegal start char constant \"" + c + "\"");
+      auto at = symbolPosition();
+      throw LexerException(at.line, at.column - 1, "Error: Illegal start char constant \"" + c + "\"");
     }
     case (-82): {
-      throw LexerException(line, beginToken, "Error: Illegal double \"" + strToken + "\"");
+      auto at = tokenStart();
+      throw LexerException(at.line, at.column, "Error: Illegal double \"" + std::string(lexeme()) + "\"");
     }
     case (-83): {
       throw LexerException("Error: Unexpected end of file");
@@ -37,38 +94,78 @@ void Lexer::errorHandler(int state) {
   }
 }
 
-// TODO move constant to state_table
-void Lexer::checkLenId(int prevState, int newState) {
-  bool isIdContinue = (prevState == ID_CONTINUE_STATE_1 && newState == ID_CONTINUE_STATE_1) ||
-                      (prevState == ID_CONTINUE_STATE_2 && newState == ID_CONTINUE_STATE_2);
-  if (isIdContinue && valToken.size() > maxLenId) {
-    throw LexerException(line, beginToken, "Error: Identifier exceed maximum length");
+int Lexer::getSymbol() {
+  if (mode == SourceMode::Stream) {
+    return readFile.get();
   }
+  isEndSource = cursor == sourceEnd;
+  if (isEndSource) {
+    return -1;
+  }
+  return static_cast<unsigned char>(*cursor++);
 }
 
-bool Lexer::isEndComment(int prevState, int newState) {
-  return newState == END_COMMENT_STATE &&
-         (prevState == BEGIN_COMMENT_STATE_1 ||
-          prevState == BEGIN_COMMENT_STATE_2 ||
-          prevState == BEGIN_COMMENT_STATE_3);
+// end of file is never consumed, so there is nothing to step back over
+void Lexer::putBack(int symbol) {
+  if (mode == SourceMode::Stream) {
+    readFile.putback(symbol);
+  } else if (!isEndSource) {
+    --cursor;
+  }
+  isEndSource = false;
 }
 
-bool Lexer::isPreview(int state) {
-  return state < 0 && withoutPreview.count(state) == 0;
+// same effect as walking the DFA over every byte of the run
+void Lexer::skipRun(int state) {
+  auto& run = table::run[state];
+  auto r = scanRun(run, cursor, sourceEnd);
+  if (r.length == 0) {
+    return;
+  }
+  const char* begin = cursor;
+  cursor += r.length;
+
+  if (run.action & table::AppendValue) {
+    valToken.append(begin, r.length);
+  }
+  if (run.action & table::AppendLexeme) {
+    if (lexemeLength == 0) {
+      lexemeBegin = begin;
+    }
+    lexemeLength += r.length;
+  }
+  if ((run.action & table::CheckLenId) && valToken.size() > maxLenId) {
+    auto at = tokenStart();
+    throw LexerException(at.line, at.column, "Error: Identifier exceed maximum length");
+  }
 }
 
-bool Lexer::isWhitespace(int prevState, int newState) {
-  return prevState == START_STATE && newState == START_STATE;
+std::string_view Lexer::lexeme() const {
+  if (mode == SourceMode::Stream) {
+    return strToken;
+  }
+  return {lexemeBegin, lexemeLength};
+}
+
+// value is usually a slice of the lexeme (keyword, string without quotes),
+// only folded or escaped text is copied into the pool
+std::string_view Lexer::cookedValue(std::string_view lexeme) {
+  auto pos = lexeme.find(valToken);
+  if (pos != std::string_view::npos) {
+    return lexeme.substr(pos, valToken.size());
+  }
+  return pool.store(valToken);
 }
 
 Token Lexer::next() {
   if (readFile.bad()) {
-    return Token(line, beginToken, TokenType::EndOfFile);
+    return Token(SourcePoint(line, beginToken), TokenType::EndOfFile);
   }
 
-  strToken = "";
-  valToken = "";
-  std::string charConstant;
+  strToken.clear();
+  valToken.clear();
+  charConstant.clear();
+  lexemeLength = 0;
 
   int prevState = startState;
   int newState = startState;
@@ -76,103 +173,146 @@ Token Lexer::next() {
 
   numSymbol = beginToken = column;
 
+  // bytes the DFA stayed in prevState, short runs are cheaper to walk
+  int loops = 0;
+
   for (; newState >= 0; prevState = newState) {
-    curSymbol = readFile.get();
+    if (loops == minScanRun && scanRun && table::run[prevState].numRange > 0) {
+      skipRun(prevState);
+    }
+    curSymbol = getSymbol();
     if (curSymbol < 0) {
       curSymbol = 4;
     } // hack to end file
 
-    newState = stateTable[prevState][curSymbol];
-    std::pair<int, int> pairState(prevState, newState);
+    auto& t = table::transition[prevState][table::symbolClass.of[curSymbol]];
+    newState = t.next;
+    loops = newState == prevState ? loops + 1 : 0;
+    auto action = t.action;
 
     // change base if we can
-    if (changeBaseInt.count(pairState) > 0) {
-      baseIntConvert = changeBaseInt.at(pairState);
+    if (action & table::ChangeBase) {
+      baseIntConvert = t.base;
     }
 
-    if (charConstantEnd.count(pairState) > 0) {
-      valToken += std::stoi(charConstant, nullptr, baseIntConvert);
-      charConstant = "";
-    } else if (charConstantAdd.count(pairState) > 0) {
+    if (action & table::CharConstantEnd) {
+      auto code = literal::toInt(charConstant, baseIntConvert, std::numeric_limits<int>::max());
+      if (code.isError) {
+        auto at = tokenStart();
+        throw LexerException(at.line, at.column, "Error: Illegal char constant \"" + charConstant + "\"");
+      }
+      if (code.isOverflow) {
+        auto at = tokenStart();
+        throw LexerException(at.line, at.column, "Error: Char constant out of range \"" + charConstant + "\"");
+      }
+      valToken += static_cast<char>(code.value);
+      charConstant.clear();
+    } else if (action & table::CharConstantAdd) {
       charConstant += curSymbol;
-    } else if (skipSymbol.count(pairState) == 0 && !isPreview(newState)) {
+    } else if (action & table::AppendValue) {
       valToken += curSymbol;
     }
 
-    if (!isWhitespace(prevState, newState) && !isPreview(newState)) {
-      strToken += curSymbol;
+    if (action & table::AppendLexeme) {
+      if (mode == SourceMode::Stream) {
+        strToken += curSymbol;
+      } else if (lexemeLength++ == 0) {
+        lexemeBegin = cursor - 1;
+      }
     }
 
-    if (curSymbol == '\n' && newState >= 0) {
+    if (action & countActions & table::NewLine) {
       ++line;
       numSymbol = beginToken = 1;
-    } else if (curSymbol != '\n') {
+    } else if (action & countActions & table::NextColumn) {
       ++numSymbol;
-      if (newState == startState) {
+      if (action & table::Whitespace) {
         ++beginToken;
       }
     }
 
-    if (isEndComment(prevState, newState)) {
+    if (action & table::EndComment) {
       beginToken = numSymbol;
-      valToken = strToken = "";
+      valToken.clear();
+      strToken.clear();
+      lexemeLength = 0;
     }
 
-    checkLenId(prevState, newState);
+    if ((action & table::CheckLenId) && valToken.size() > maxLenId) {
+      auto at = tokenStart();
+      throw LexerException(at.line, at.column, "Error: Identifier exceed maximum length");
+    }
   }
 
   errorHandler(newState);
 
   if (readFile.bad() || newState == eofState) {
-    return Token(line, beginToken, TokenType::EndOfFile);
+    return Token(tokenPoint(), TokenType::EndOfFile);
   }
 
-  if (withoutPreview.count(newState) == 0) {
-    readFile.putback(curSymbol);
+  auto& finish = table::finalState[-newState];
+  if (finish.isPreview) {
+    putBack(curSymbol);
     --numSymbol;
     if (newState == twicePutbackState) {
-      readFile.putback(strToken.back());
+      if (mode == SourceMode::Stream) {
+        putBack(strToken.back());
+        strToken.pop_back();
+      } else {
+        putBack(lexemeBegin[--lexemeLength]);
+      }
       --numSymbol;
-      strToken.pop_back();
     }
   }
 
   column = numSymbol;
-  auto tokenType = toTokenType.at(newState);
+  auto point = tokenPoint();
+  auto tokenType = finish.type;
+  auto lex = mode == SourceMode::Stream ? pool.store(strToken) : lexeme();
 
-  if (tokenType ==  TokenType::Id) {
-    std::transform(valToken.begin(), valToken.end(), valToken.begin(), ::tolower);
+  if (newState == checkIdState) {
+    auto keyword = keyword::find(valToken);
+    if (keyword != TokenType::Id) {
+      return Token(point, keyword, getSpelling(keyword), lex);
+    }
   }
 
-  if (newState == checkIdState && isKeyword(valToken)) {
-    tokenType = getKeywordType(valToken);
-    return Token(line, beginToken, tokenType, valToken, strToken);
+  if (tokenType ==  TokenType::Id) {
+    std::transform(valToken.begin(), valToken.end(), valToken.begin(), ::tolower);
   }
 
   switch (tokenType) {
     case TokenType::Int: {
-      uint64_t value = std::stoll(valToken, nullptr, baseIntConvert);
-      return Token(line, beginToken, value, strToken);
+      auto digits = baseIntConvert == 10 ? lex : lex.substr(1);
+      auto value = literal::toInt(digits, baseIntConvert);
+      if (value.isError) {
+        auto at = point.get();
+        throw LexerException(at.line, at.column, "Error: Illegal integer constant \"" + std::string(lex) + "\"");
+      }
+      if (value.isOverflow) {
+        auto at = point.get();
+        throw LexerException(at.line, at.column, "Error: Integer constant out of range \"" + std::string(lex) + "\"");
+      }
+      return Token(point, value.value, lex);
     }
     case TokenType::Double: {
-      auto value = std::stold(valToken);
-      return Token(line, beginToken, value, strToken);
+      auto value = literal::toDouble(lex);
+      if (value.isOverflow) {
+        auto at = point.get();
+        throw LexerException(at.line, at.column, "Error: Double constant out of range \"" + std::string(lex) + "\"");
+      }
+      return Token(point, value.value, lex);
+    }
+    case TokenType::String: {
+      return Token(point, tokenType, cookedValue(lex), lex);
     }
-    case TokenType::String:
     case TokenType::Id: {
-      return Token(line, beginToken, tokenType, valToken, strToken);
+      return Token(point, intern(valToken), lex);
     }
     default: {
-      return Token(line, beginToken, tokenType, strToken);
+      return Token(point, tokenType, lex);
     }
   }
 
 }
 
-
-template<class T1, class T2>
-std::size_t Lexer::pairHash::operator()(const std::pair<T1, T2>& p) const {
-  auto h1 = std::hash<T1>{}(p.first);
-  auto h2 = std::hash<T2>{}(p.second);
-  return h1 ^ h2;
-};
\ No newline at end of file
@@ -3,56 +3,80 @@
 #include <memory>
 #include <fstream>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
 
 #include "token.h"
-#include "state_table.h"
+#include "lexer_table.h"
+#include "source_buffer.h"
+#include "line_table.h"
+#include "string_pool.h"
+#include "scanner.h"
 
 namespace lx {
 
+// Buffer - DFA walks a cursor over the whole file in memory,
+// Stream - character by character through std::ifstream
+enum class SourceMode {
+  Buffer,
+  Stream
+};
+
 class Lexer {
  public:
-  explicit Lexer(const std::string&);
+  explicit Lexer(const std::string&, SourceMode = SourceMode::Buffer);
+  // lexes a buffer and its line table owned by the caller
+  // from start, which must be a token boundary
+  Lexer(const SourceBuffer&, const LineTable&, const char* start);
   ~Lexer() = default;
 
   Token next();
 
+  // state between two next() calls, buffer mode only
+  const char* position() const { return cursor; }
+
  private:
   inline void errorHandler(int state);
-  inline void checkLenId(int prevState, int newState);
-  inline bool isEndComment(int prevState, int newState);
-  inline bool isWhitespace(int prevState, int newState);
-  inline bool isPreview(int);
-
-  struct pairHash {
-    template<class T1, class T2>
-    std::size_t operator()(const std::pair<T1, T2>& p) const;
-  };
+  inline int getSymbol();
+  inline void putBack(int symbol);
+  inline void skipRun(int state);
+  inline std::string_view lexeme() const;
+  inline std::string_view cookedValue(std::string_view lexeme);
+  inline Position locate(const char*);
+  inline SourcePoint tokenPoint();
+  inline Position tokenStart();
+  inline Position symbolPosition();
 
+  // counted per character in stream mode only,
+  // buffer mode looks positions up in the line table
   int line, column;
   int curSymbol;
   int beginToken, numSymbol;
+  uint16_t countActions = 0;
 
-  std::string strToken, valToken;
+  // scratch reused between tokens, strToken is only filled in stream mode,
+  // in buffer mode the lexeme is the source range lexemeBegin..+lexemeLength
+  std::string strToken, valToken, charConstant;
+  const char* lexemeBegin = nullptr;
+  std::size_t lexemeLength = 0;
+  StringPool pool;
 
+  SourceMode mode;
   std::ifstream readFile;
+  SourceBuffer source;
+  const char* sourceBegin = nullptr;
+  const char* cursor = nullptr;
+  const char* sourceEnd = nullptr;
+  LineTable ownLines;
+  const LineTable* sharedLines = nullptr;
+  bool isEndSource = false;
+  Scanner scanRun = nullptr;
 
   const int startState = START_STATE;
   const int eofState = EOF_STATE;
   const int checkIdState = CHECK_ID;
   const int twicePutbackState = TWICE_PUT_BACK;
-  const int stateTable[38][128] = STATE_TABLE;
-
-  const int maxLenId = 144;
-
 
-  const std::unordered_set<int> withoutPreview = WITHOUT_PREVIEW;
-  const std::unordered_set<std::pair<int, int>, pairHash> skipSymbol = SKIP_SYMBOL;
-  const std::unordered_set<std::pair<int, int>, pairHash> charConstantAdd = CHAR_CONSTANT;
-  const std::unordered_set<std::pair<int, int>, pairHash> charConstantEnd = CHAR_CONSTANT_END;
-  const std::unordered_map<int, TokenType> toTokenType = FROM_FINAL_STATE_TO_TOKEN;
-  const std::unordered_map<std::pair<int, int>, int, pairHash> changeBaseInt = CHANGE_BASE;
+  static constexpr std::size_t maxLenId = 144;
+  const int minScanRun = 4;
 };
 
 }; // namespace lx
\ No newline at end of file
@@ -1,38 +1,35 @@
 #include "lexerBuffer.h"
 
+#include <stdexcept>
+
 using namespace lx;
 
-LexerBuffer::LexerBuffer(const std::string& fileName)
-  : lexer(fileName), buffer() {}
+LexerBuffer::LexerBuffer(const std::string& fileName, SourceMode mode)
+  : lexer(fileName, mode) {}
 
 
 Token LexerBuffer::next() {
-  if (!buffer.empty()) {
-    auto tok(std::move(*buffer.begin()));
-    buffer.pop_front();
-    return tok;
+  if (count == 0) {
+    return lexer.next();
   }
-  return lexer.next();
+  Token tok(std::move(*ring[head]));
+  head = (head + 1) & (capacity - 1);
+  --count;
+  return tok;
 }
 
-const Token& LexerBuffer::get() {
-  ListToken::iterator it;
-
-  if (!buffer.empty()) {
-    it = buffer.begin();
-  } else {
-    buffer.emplace_back(lexer.next());
-    it = --buffer.end();
+const Token& LexerBuffer::peek(std::size_t k) {
+  if (k >= capacity) {
+    throw std::logic_error("LexerBuffer lookahead " + std::to_string(k) + " exceeds capacity");
   }
-
-  return *it;
-}
-
-void LexerBuffer::push_back(Token t) {
-  buffer.emplace_back(std::move(t));
+  while (count <= k) {
+    ring[(head + count) & (capacity - 1)].emplace(lexer.next());
+    ++count;
+  }
+  return *ring[(head + k) & (capacity - 1)];
 }
 
 LexerBuffer& LexerBuffer::operator++() {
   next();
   return *this;
-}
\ No newline at end of file
+}
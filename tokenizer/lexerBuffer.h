@@ -1,7 +1,8 @@
 #pragma once
 
-#include <memory>
-#include <list>
+#include <array>
+#include <cstddef>
+#include <optional>
 #include <string>
 
 #include "token.h"
@@ -9,18 +10,27 @@
 
 namespace lx {
 
+// Fixed ring of lexed but not yet consumed tokens,
+// lookahead never allocates.
 class LexerBuffer {
  public:
-  explicit LexerBuffer(const std::string& fileName);
+  static constexpr std::size_t capacity = 4;
+
+  explicit LexerBuffer(const std::string& fileName, SourceMode = SourceMode::Buffer);
 
   Token next();
-  const Token& get();
-  void push_back(Token token);
+  const Token& get() { return peek(0); }
+  // k-th token after the current one, k < capacity
+  const Token& peek(std::size_t k);
   LexerBuffer& operator++();
 
  private:
+  static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
   Lexer lexer;
-  std::list<Token> buffer;
+  std::array<std::optional<Token>, capacity> ring;
+  std::size_t head = 0;
+  std::size_t count = 0;
 };
 
-} // namespace lexer
\ No newline at end of file
+} // namespace lexer
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include "token_type.h"
+#include "state_table.h"
+
+// Compile time view of state_table.h: input symbols are folded into
+// equivalence classes and every (state, class) cell carries the next state
+// together with the actions Lexer::next() has to perform on that transition.
+
+namespace lx {
+namespace table {
+
+constexpr int numState = 38;
+constexpr int numSymbol = 128;
+constexpr int numFinal = 84; // final states -1 .. -83
+
+enum Action : uint16_t {
+  AppendValue     = 1 << 0,
+  AppendLexeme    = 1 << 1,
+  CharConstantAdd = 1 << 2,
+  CharConstantEnd = 1 << 3,
+  ChangeBase      = 1 << 4,
+  NewLine         = 1 << 5,
+  NextColumn      = 1 << 6,
+  Whitespace      = 1 << 7,
+  EndComment      = 1 << 8,
+  CheckLenId      = 1 << 9,
+};
+
+struct Transition {
+  int8_t next;
+  uint8_t base;
+  uint16_t action;
+};
+
+struct Final {
+  TokenType type = TokenType::Non;
+  bool isPreview = false;
+};
+
+inline constexpr int stateTable[numState][numSymbol] = STATE_TABLE;
+inline constexpr int withoutPreview[] = WITHOUT_PREVIEW;
+inline constexpr std::pair<int, int> skipSymbol[] = SKIP_SYMBOL;
+inline constexpr std::pair<int, int> charConstantAdd[] = CHAR_CONSTANT;
+inline constexpr std::pair<int, int> charConstantEnd[] = CHAR_CONSTANT_END;
+inline constexpr std::pair<std::pair<int, int>, int> changeBase[] = CHANGE_BASE;
+inline constexpr std::pair<int, TokenType> finalToken[] = FROM_FINAL_STATE_TO_TOKEN;
+
+template <class T, std::size_t N>
+constexpr bool contains(const T (&list)[N], const T& e) {
+  for (auto& i : list) {
+    if (i == e) { return true; }
+  }
+  return false;
+}
+
+constexpr bool isPreview(int state) {
+  return state < 0 && !contains(withoutPreview, state);
+}
+
+constexpr bool sameColumn(int a, int b) {
+  for (int s = 0; s < numState; ++s) {
+    if (stateTable[s][a] != stateTable[s][b]) { return false; }
+  }
+  return true;
+}
+
+struct SymbolClasses {
+  std::array<uint8_t, 256> of{};
+  std::array<uint8_t, numSymbol> symbol{}; // representative of class
+  int count = 0;
+};
+
+constexpr SymbolClasses makeSymbolClasses() {
+  SymbolClasses r{};
+  for (int c = 0; c < numSymbol; ++c) {
+    int k = 0;
+    // '\n' moves line bookkeeping, keep it in its own class
+    while (k < r.count && (c == '\n' || r.symbol[k] == '\n' || !sameColumn(c, r.symbol[k]))) {
+      ++k;
+    }
+    if (k == r.count) {
+      r.symbol[r.count++] = c;
+    }
+    r.of[c] = k;
+  }
+  // bytes outside ASCII behave as DEL: only valid inside strings and comments
+  for (int c = numSymbol; c < 256; ++c) {
+    r.of[c] = r.of[127];
+  }
+  return r;
+}
+
+inline constexpr SymbolClasses symbolClass = makeSymbolClasses();
+constexpr int numClass = symbolClass.count;
+
+using TransitionTable = std::array<std::array<Transition, numClass>, numState>;
+
+constexpr Transition makeTransition(int prev, int symbol) {
+  int next = stateTable[prev][symbol];
+  auto pair = std::make_pair(prev, next);
+  uint16_t action = 0;
+  uint8_t base = 0;
+
+  for (auto& e : changeBase) {
+    if (e.first == pair) {
+      action |= ChangeBase;
+      base = e.second;
+      break;
+    }
+  }
+  if (contains(charConstantEnd, pair)) {
+    action |= CharConstantEnd;
+  } else if (contains(charConstantAdd, pair)) {
+    action |= CharConstantAdd;
+  } else if (!contains(skipSymbol, pair) && !isPreview(next)) {
+    action |= AppendValue;
+  }
+  bool isWhitespace = prev == START_STATE && next == START_STATE;
+  if (!isWhitespace && !isPreview(next)) {
+    action |= AppendLexeme;
+  }
+  if (symbol == '\n' && next >= 0) {
+    action |= NewLine;
+  } else if (symbol != '\n') {
+    action |= NextColumn;
+    if (next == START_STATE) {
+      action |= Whitespace;
+    }
+  }
+  if (next == END_COMMENT_STATE &&
+      (prev == BEGIN_COMMENT_STATE_1 || prev == BEGIN_COMMENT_STATE_2 || prev == BEGIN_COMMENT_STATE_3)) {
+    action |= EndComment;
+  }
+  if ((prev == ID_CONTINUE_STATE_1 || prev == ID_CONTINUE_STATE_2) && next == prev) {
+    action |= CheckLenId;
+  }
+  return Transition{static_cast<int8_t>(next), base, action};
+}
+
+constexpr TransitionTable makeTransitionTable() {
+  TransitionTable t{};
+  for (int s = 0; s < numState; ++s) {
+    for (int k = 0; k < numClass; ++k) {
+      t[s][k] = makeTransition(s, symbolClass.symbol[k]);
+    }
+  }
+  return t;
+}
+
+constexpr std::array<Final, numFinal> makeFinalTable() {
+  std::array<Final, numFinal> f{};
+  for (int s = 1; s < numFinal; ++s) {
+    f[s].isPreview = isPreview(-s);
+  }
+  for (auto& e : finalToken) {
+    f[-e.first].type = e.second;
+  }
+  return f;
+}
+
+inline constexpr TransitionTable transition = makeTransitionTable();
+inline constexpr std::array<Final, numFinal> finalState = makeFinalTable();
+
+// Bytes a state loops on with one and the same action (whitespace, comment
+// and string bodies, identifier and digit runs) as at most maxRange byte
+// ranges, so a scanner can consume the run without walking the table.
+// '\n' may belong to a run, it only changes line bookkeeping.
+constexpr int maxRange = 6;
+
+struct Run {
+  uint16_t action = 0;
+  bool isStop = false; // ranges list the bytes that end the run
+  uint8_t numRange = 0; // 0 - state has no run
+  uint8_t lo[maxRange] = {};
+  uint8_t hi[maxRange] = {};
+};
+
+constexpr uint16_t notRunAction = ChangeBase | CharConstantAdd | CharConstantEnd | EndComment;
+constexpr uint16_t appendAction = AppendValue | AppendLexeme | CheckLenId;
+
+constexpr Run makeRun(int state) {
+  Run r{};
+  bool inRun[256] = {};
+  bool isFound = false;
+  for (int c = 0; c < 256; ++c) {
+    auto& t = transition[state][symbolClass.of[c]];
+    if (c == '\n' || t.next != state || (t.action & notRunAction)) {
+      continue;
+    }
+    if (!isFound) {
+      r.action = t.action;
+      isFound = true;
+    }
+    inRun[c] = t.action == r.action;
+  }
+  if (!isFound) {
+    return r;
+  }
+  auto& n = transition[state][symbolClass.of['\n']];
+  inRun['\n'] = n.next == state && !(n.action & notRunAction) &&
+                (n.action & appendAction) == (r.action & appendAction);
+
+  // bytes above 127 share one class, describe the ascii complement instead
+  r.isStop = inRun[numSymbol];
+  int numRange = 0;
+  for (int c = 0; c < numSymbol; ++c) {
+    if (inRun[c] == r.isStop) {
+      continue;
+    }
+    if (numRange > 0 && r.hi[numRange - 1] == c - 1) {
+      r.hi[numRange - 1] = c;
+      continue;
+    }
+    if (numRange == maxRange) {
+      return Run{};
+    }
+    r.lo[numRange] = r.hi[numRange] = c;
+    ++numRange;
+  }
+  r.numRange = numRange;
+  return r;
+}
+
+constexpr std::array<Run, numState> makeRunTable() {
+  std::array<Run, numState> r{};
+  for (int s = 0; s < numState; ++s) {
+    r[s] = makeRun(s);
+  }
+  return r;
+}
+
+inline constexpr std::array<Run, numState> run = makeRunTable();
+
+static_assert(numClass < 256, "symbol class must fit in a byte");
+static_assert(sizeof(TransitionTable) <= 8 * 1024, "transition table should stay in L1");
+
+} // namespace table
+} // namespace lx
@@ -0,0 +1,93 @@
+#include "line_table.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LX_LINE_TABLE_X86
+#endif
+
+using namespace lx;
+
+namespace {
+
+// first pass counts, second pass writes the starts into the reserved vector
+struct Count {
+  std::size_t lines = 0;
+  void operator()(uint32_t mask, std::size_t) { lines += __builtin_popcount(mask); }
+};
+
+struct Push {
+  std::vector<std::size_t>& starts;
+  void operator()(uint32_t mask, std::size_t offset) {
+    while (mask) {
+      starts.push_back(offset + __builtin_ctz(mask) + 1);
+      mask &= mask - 1;
+    }
+  }
+};
+
+#ifdef LX_LINE_TABLE_X86
+
+template <class F>
+__attribute__((target("avx2")))
+std::size_t scanAvx2(F& f, const char* begin, const char* end) {
+  const __m256i newLine = _mm256_set1_epi8('\n');
+  const char* p = begin;
+  for (; end - p >= 32; p += 32) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    f(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, newLine)), p - begin);
+  }
+  return p - begin;
+}
+
+template <class F>
+__attribute__((target("sse2")))
+std::size_t scanSse2(F& f, const char* begin, const char* end) {
+  const __m128i newLine = _mm_set1_epi8('\n');
+  const char* p = begin;
+  for (; end - p >= 16; p += 16) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    f(_mm_movemask_epi8(_mm_cmpeq_epi8(x, newLine)), p - begin);
+  }
+  return p - begin;
+}
+
+#endif
+
+template <class F>
+void scan(F& f, const char* begin, const char* end) {
+  std::size_t done = 0;
+#ifdef LX_LINE_TABLE_X86
+  if (__builtin_cpu_supports("avx2")) {
+    done = scanAvx2(f, begin, end);
+  } else if (__builtin_cpu_supports("sse2")) {
+    done = scanSse2(f, begin, end);
+  }
+#endif
+  for (auto p = begin + done; p < end; ++p) {
+    f(*p == '\n', p - begin);
+  }
+}
+
+} // namespace
+
+LineTable::LineTable(const char* begin, const char* end) {
+#ifdef LX_LINE_TABLE_X86
+  __builtin_cpu_init();
+#endif
+  Count count;
+  scan(count, begin, end);
+  starts.reserve(count.lines + 1);
+  Push push{starts};
+  scan(push, begin, end);
+}
+
+std::size_t LineTable::find(std::size_t offset) const {
+  return std::upper_bound(starts.begin(), starts.end(), offset) - starts.begin() - 1;
+}
+
+Position LineTable::locate(std::size_t offset) const {
+  return at(find(offset), offset);
+}
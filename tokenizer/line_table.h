@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace lx {
+
+struct Position {
+  int line = 1;
+  int column = 1;
+};
+
+// Offsets of the line starts of a source buffer, found once by a
+// vectorised scan for '\n'. Tokens keep byte offsets, line and column
+// are looked up only when a diagnostic or a test line asks for them.
+class LineTable {
+ public:
+  LineTable() = default;
+  LineTable(const char* begin, const char* end);
+
+  // binary search
+  Position locate(std::size_t offset) const;
+
+  std::size_t getNumLine() const { return starts.size(); }
+
+ private:
+  // last line that starts at or before offset
+  std::size_t find(std::size_t offset) const;
+  Position at(std::size_t line, std::size_t offset) const {
+    return {static_cast<int>(line + 1), static_cast<int>(offset - starts[line] + 1)};
+  }
+
+  std::vector<std::size_t> starts{0};
+};
+
+} // namespace lx
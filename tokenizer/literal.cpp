@@ -0,0 +1,138 @@
+#include "literal.h"
+
+#include <array>
+#include <charconv>
+#include <limits>
+#include <system_error>
+
+using namespace lx;
+using namespace lx::literal;
+
+namespace {
+
+constexpr std::array<uint8_t, 256> makeDigitTable() {
+  std::array<uint8_t, 256> d{};
+  for (auto& e : d) {
+    e = 0xff;
+  }
+  for (int c = '0'; c <= '9'; ++c) {
+    d[c] = c - '0';
+  }
+  for (int c = 'a'; c <= 'f'; ++c) {
+    d[c] = d[c - 'a' + 'A'] = c - 'a' + 10;
+  }
+  return d;
+}
+
+constexpr std::array<uint8_t, 256> digitValue = makeDigitTable();
+
+// $ & % : every digit is a fixed number of bits,
+// the value overflows as soon as a set bit is shifted out of the top
+template <int bits>
+Result<uint64_t> toIntPow2(std::string_view digits) {
+  constexpr int top = 64 - bits;
+  Result<uint64_t> r;
+  r.isError = digits.empty();
+  for (unsigned char c : digits) {
+    if (digitValue[c] >> bits) {
+      r.isError = true;
+      return r;
+    }
+    if (r.value >> top) {
+      r.isOverflow = true;
+      return r;
+    }
+    r.value = (r.value << bits) | digitValue[c];
+  }
+  return r;
+}
+
+// Clinger's fast path: a mantissa of at most 19 digits and 10^e below 2^64
+// are both exact in x87 long double, one multiplication or division
+// then rounds correctly, same as strtold
+constexpr int maxFastDigits = 19;
+constexpr int maxFastExponent = 27;
+constexpr bool hasFastPath = std::numeric_limits<long double>::digits >= 64;
+
+constexpr std::array<long double, maxFastExponent + 1> makePow10() {
+  std::array<long double, maxFastExponent + 1> p{};
+  p[0] = 1;
+  for (int i = 1; i <= maxFastExponent; ++i) {
+    p[i] = p[i - 1] * 10;
+  }
+  return p;
+}
+
+constexpr std::array<long double, maxFastExponent + 1> pow10 = makePow10();
+
+bool toDoubleFast(std::string_view text, long double& value) {
+  uint64_t mantissa = 0;
+  int digits = 0, exponent = 0;
+  std::size_t i = 0;
+  bool isFraction = false;
+  for (; i < text.size(); ++i) {
+    char c = text[i];
+    if (c == '.') {
+      isFraction = true;
+      continue;
+    }
+    if (c < '0' || c > '9') {
+      break;
+    }
+    if (digits > 0 || c != '0') {
+      if (++digits > maxFastDigits) {
+        return false;
+      }
+    }
+    mantissa = mantissa * 10 + (c - '0');
+    exponent -= isFraction;
+  }
+  if (i < text.size()) { // e[+-]digits
+    int sign = 1, e = 0;
+    ++i;
+    if (i < text.size() && (text[i] == '+' || text[i] == '-')) {
+      sign = text[i++] == '-' ? -1 : 1;
+    }
+    for (; i < text.size(); ++i) {
+      e = e * 10 + (text[i] - '0');
+      if (e > 4 * maxFastExponent) {
+        return false;
+      }
+    }
+    exponent += sign * e;
+  }
+  if (exponent < -maxFastExponent || exponent > maxFastExponent) {
+    return false;
+  }
+  value = mantissa;
+  value = exponent < 0 ? value / pow10[-exponent] : value * pow10[exponent];
+  return true;
+}
+
+} // namespace
+
+Result<uint64_t> lx::literal::toInt(std::string_view digits, int base, uint64_t max) {
+  Result<uint64_t> r;
+  switch (base) {
+    case 16: r = toIntPow2<4>(digits); break;
+    case 8:  r = toIntPow2<3>(digits); break;
+    case 2:  r = toIntPow2<1>(digits); break;
+    default: {
+      auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), r.value);
+      r.isOverflow = ec == std::errc::result_out_of_range;
+      r.isError = ec == std::errc::invalid_argument || ptr != digits.data() + digits.size();
+    }
+  }
+  r.isOverflow = r.isOverflow || r.value > max;
+  return r;
+}
+
+Result<long double> lx::literal::toDouble(std::string_view text) {
+  Result<long double> r;
+  if (hasFastPath && toDoubleFast(text, r.value)) {
+    return r;
+  }
+  auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), r.value);
+  r.isOverflow = ec == std::errc::result_out_of_range;
+  return r;
+}
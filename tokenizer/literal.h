@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+namespace lx {
+namespace literal {
+
+// Conversion of numeric literal text, in the spirit of std::from_chars:
+// no locale, no allocation, no exceptions. The lexer does not check every
+// digit (an identifier like ABCDEF can reach toInt), so callers handle
+// isError as well as isOverflow.
+
+template <class T>
+struct Result {
+  T value{};
+  bool isOverflow = false;
+  // empty, or a character that is not a digit of the base
+  bool isError = false;
+};
+
+constexpr uint64_t maxInt = std::numeric_limits<int64_t>::max();
+
+// digits without the $ & % prefix, base is 2, 8, 10 or 16
+Result<uint64_t> toInt(std::string_view digits, int base, uint64_t max = maxInt);
+
+Result<long double> toDouble(std::string_view text);
+
+} // namespace literal
+} // namespace lx
@@ -0,0 +1,135 @@
+#include "parallel_lexer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+using namespace lx;
+
+namespace {
+
+// f(chunks[0]) runs on the calling thread, the rest on one thread each
+template <class Chunks, class F>
+void forEachChunk(Chunks& chunks, F f) {
+  if (chunks.empty()) {
+    return;
+  }
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < chunks.size(); ++i) {
+    workers.emplace_back([&f, &chunks, i] { f(chunks[i]); });
+  }
+  f(chunks[0]);
+  for (auto& w : workers) {
+    w.join();
+  }
+}
+
+} // namespace
+
+ParallelLexer::ParallelLexer(const std::string& fileName, unsigned numThread)
+  : source(fileName) {
+  if (source.size() > UINT32_MAX) {
+    throw std::length_error("Parallel lexing needs a source below 4 GB");
+  }
+  lines = LineTable(source.begin(), source.end());
+  split(numThread);
+  forEachChunk(chunks, [this](Chunk& c) {
+    lex(c, c.begin);
+  });
+  stitch();
+}
+
+void ParallelLexer::split(unsigned numThread) {
+  auto size = source.size();
+  std::size_t n = std::max<std::size_t>(1, std::min<std::size_t>(numThread, size / minChunkSize));
+  const char* begin = source.begin();
+  for (std::size_t i = 1; i <= n; ++i) {
+    const char* end = source.end();
+    if (i < n) {
+      auto p = source.begin() + size / n * i;
+      auto nl = static_cast<const char*>(std::memchr(p, '\n', source.end() - p));
+      end = nl ? nl + 1 : source.end();
+    }
+    if (end <= begin) {
+      continue;
+    }
+    chunks.emplace_back();
+    chunks.back().begin = begin;
+    chunks.back().end = end;
+    begin = end;
+  }
+}
+
+void ParallelLexer::lex(Chunk& c, const char* start) {
+  c.tokens.clear();
+  c.error = nullptr;
+  c.isEndOfFile = false;
+  // a token takes a few bytes at least, pages reserved but never touched cost nothing
+  c.tokens.reserve(static_cast<std::size_t>(c.end - start) / 2 + 1);
+  c.lexer = std::make_unique<Lexer>(source, lines, start);
+  auto& lexer = *c.lexer;
+  try {
+    while (true) {
+      auto token = lexer.next();
+      if (token.is(TokenType::EndOfFile)) {
+        c.isEndOfFile = true;
+        break;
+      }
+      c.tokens.push(token, source.begin());
+      if (lexer.position() >= c.end) {
+        break;
+      }
+    }
+  } catch (...) {
+    c.error = std::current_exception();
+  }
+  c.stop = lexer.position();
+}
+
+void ParallelLexer::stitch() {
+  const char* expected = source.begin();
+  for (auto& c : chunks) {
+    // the last token of the previous chunk ran over this one
+    if (expected >= c.end) {
+      continue;
+    }
+    std::size_t first = 0;
+    if (expected != c.begin) {
+      std::size_t offset = expected - source.begin();
+      auto it = std::lower_bound(c.tokens.begin(), c.tokens.end(), offset,
+                                 [](const CompactToken& t, std::size_t o) { return t.end() < o; });
+      if (it != c.tokens.end() && it->end() == offset) {
+        first = it - c.tokens.begin() + 1;
+      } else {
+        ++numRelex;
+        lex(c, expected);
+      }
+    }
+    c.first = first;
+    c.last = c.tokens.size();
+    if (c.error) {
+      error = c.error;
+      return;
+    }
+    if (c.isEndOfFile) {
+      return;
+    }
+    expected = c.stop;
+  }
+}
+
+std::size_t ParallelLexer::getNumToken() const {
+  std::size_t n = 0;
+  for (auto& c : chunks) {
+    n += c.last - c.first;
+  }
+  return n;
+}
+
+void ParallelLexer::checkError() const {
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "compact_token.h"
+#include "lexer.h"
+#include "line_table.h"
+#include "source_buffer.h"
+
+namespace lx {
+
+// Lexes a whole file in newline aligned chunks, one thread per chunk.
+// Every chunk is lexed speculatively from START_STATE; a chunk whose
+// first line actually continues a comment of the previous one is re-lexed
+// from where the previous chunk stopped. The token stream and the first
+// error are the same as those of a serial Lexer.
+class ParallelLexer {
+ public:
+  ParallelLexer(const std::string& fileName, unsigned numThread);
+
+  // f(const Token&) for the tokens before EndOfFile or before the error
+  template <class F>
+  void forEachToken(F f) const {
+    for (auto& c : chunks) {
+      for (auto i = c.first; i < c.last; ++i) {
+        f(c.tokens.expand(c.tokens[i], source.begin(), lines));
+      }
+    }
+  }
+  std::size_t getNumToken() const;
+  // throws the LexerException the serial lexer would stop with, if any
+  void checkError() const;
+
+  std::size_t getNumChunk() const { return chunks.size(); }
+  std::size_t getNumRelex() const { return numRelex; }
+
+ private:
+  struct Chunk {
+    const char* begin;
+    const char* end;
+    // a lexer left at the end of tokens[i] continues
+    // exactly like the one that produced tokens[i + 1]
+    TokenTable tokens;
+    const char* stop;
+    std::exception_ptr error;
+    bool isEndOfFile = false;
+    std::unique_ptr<Lexer> lexer; // owns the pool token values may view
+    std::size_t first = 0, last = 0; // tokens taken into the stream
+  };
+
+  static constexpr std::size_t minChunkSize = 1 << 16;
+
+  void split(unsigned numThread);
+  void lex(Chunk&, const char* start);
+  void stitch();
+
+  SourceBuffer source;
+  LineTable lines;
+  std::vector<Chunk> chunks;
+  std::exception_ptr error;
+  std::size_t numRelex = 0;
+};
+
+} // namespace lx
@@ -0,0 +1,98 @@
+#include "scanner.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LX_SCANNER_X86
+#endif
+
+using namespace lx;
+
+namespace {
+
+ScanResult scanNone(const table::Run&, const char*, const char*) {
+  return {};
+}
+
+#ifdef LX_SCANNER_X86
+
+// stop - bytes of the block that end the run,
+// returns false when the run ends inside this block
+inline bool consumeBlock(const char*& p, int width, uint32_t stop) {
+  int length = stop ? __builtin_ctz(stop) : width;
+  length = length < width ? length : width;
+  p += length;
+  return length == width;
+}
+
+// x in [lo, hi] <=> (x - lo) - (hi - lo) saturates to zero
+
+__attribute__((target("sse2")))
+ScanResult scanSse2(const table::Run& run, const char* begin, const char* end) {
+  __m128i lo[table::maxRange], width[table::maxRange];
+  for (int i = 0; i < run.numRange; ++i) {
+    lo[i] = _mm_set1_epi8(static_cast<char>(run.lo[i]));
+    width[i] = _mm_set1_epi8(static_cast<char>(run.hi[i] - run.lo[i]));
+  }
+  const __m128i zero = _mm_setzero_si128();
+
+  ScanResult r;
+  const char* p = begin;
+  while (end - p >= 16) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i in = zero;
+    for (int i = 0; i < run.numRange; ++i) {
+      in = _mm_or_si128(in, _mm_cmpeq_epi8(_mm_subs_epu8(_mm_sub_epi8(x, lo[i]), width[i]), zero));
+    }
+    uint32_t mask = _mm_movemask_epi8(in);
+    if (!consumeBlock(p, 16, run.isStop ? mask : ~mask)) {
+      break;
+    }
+  }
+  r.length = p - begin;
+  return r;
+}
+
+__attribute__((target("avx2")))
+ScanResult scanAvx2(const table::Run& run, const char* begin, const char* end) {
+  __m256i lo[table::maxRange], width[table::maxRange];
+  for (int i = 0; i < run.numRange; ++i) {
+    lo[i] = _mm256_set1_epi8(static_cast<char>(run.lo[i]));
+    width[i] = _mm256_set1_epi8(static_cast<char>(run.hi[i] - run.lo[i]));
+  }
+  const __m256i zero = _mm256_setzero_si256();
+
+  ScanResult r;
+  const char* p = begin;
+  while (end - p >= 32) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i in = zero;
+    for (int i = 0; i < run.numRange; ++i) {
+      in = _mm256_or_si256(in, _mm256_cmpeq_epi8(_mm256_subs_epu8(_mm256_sub_epi8(x, lo[i]), width[i]), zero));
+    }
+    uint32_t mask = _mm256_movemask_epi8(in);
+    if (!consumeBlock(p, 32, run.isStop ? mask : ~mask)) {
+      break;
+    }
+  }
+  r.length = p - begin;
+  return r;
+}
+
+#endif
+
+} // namespace
+
+Scanner lx::selectScanner() {
+#ifdef LX_SCANNER_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return scanAvx2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return scanSse2;
+  }
+#endif
+  return scanNone;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+#include "lexer_table.h"
+
+namespace lx {
+
+struct ScanResult {
+  std::size_t length = 0;
+};
+
+// Longest prefix of [begin, end) that stays inside the run. Kernels only
+// look at whole 16/32 byte blocks, the tail is left to the DFA.
+using Scanner = ScanResult (*)(const table::Run&, const char* begin, const char* end);
+
+// widest kernel the cpu supports: AVX2, SSE2 or none
+Scanner selectScanner();
+
+} // namespace lx
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace lx {
+
+// Contiguous vector keeping up to N elements inline, so the short lists of
+// the tree (call arguments, indices, identifiers) need no allocation.
+template <class T, std::size_t N>
+class SmallVector {
+ public:
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  SmallVector() = default;
+  SmallVector(std::initializer_list<T> list) { append(list.begin(), list.end()); }
+  SmallVector(const SmallVector& o) { append(o.begin(), o.end()); }
+  SmallVector(SmallVector&& o) noexcept { take(o); }
+  ~SmallVector() { destroy(); }
+
+  SmallVector& operator=(const SmallVector& o) {
+    if (this != &o) {
+      clear();
+      append(o.begin(), o.end());
+    }
+    return *this;
+  }
+
+  SmallVector& operator=(SmallVector&& o) noexcept {
+    if (this != &o) {
+      destroy();
+      take(o);
+    }
+    return *this;
+  }
+
+  iterator begin() { return data; }
+  iterator end() { return data + length; }
+  const_iterator begin() const { return data; }
+  const_iterator end() const { return data + length; }
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  std::size_t size() const { return length; }
+  bool empty() const { return length == 0; }
+  bool isInline() const { return data == inlineData(); }
+
+  T& operator[](std::size_t i) { return data[i]; }
+  const T& operator[](std::size_t i) const { return data[i]; }
+  T& front() { return data[0]; }
+  const T& front() const { return data[0]; }
+  T& back() { return data[length - 1]; }
+  const T& back() const { return data[length - 1]; }
+
+  void push_back(const T& e) { emplace_back(e); }
+  void push_back(T&& e) { emplace_back(std::move(e)); }
+
+  template <class... Args>
+  T& emplace_back(Args&&... args) {
+    if (length == capacity) {
+      // the argument may live in this vector
+      T e(std::forward<Args>(args)...);
+      grow(capacity * 2);
+      return *new (data + length++) T(std::move(e));
+    }
+    return *new (data + length++) T(std::forward<Args>(args)...);
+  }
+
+  void pop_back() { data[--length].~T(); }
+
+  template <class It>
+  void append(It first, It last) {
+    auto n = static_cast<std::size_t>(std::distance(first, last));
+    reserve(length + n);
+    std::uninitialized_copy(first, last, data + length);
+    length += n;
+  }
+
+  void append(SmallVector&& o) {
+    reserve(length + o.length);
+    std::uninitialized_move(o.begin(), o.end(), data + length);
+    length += o.length;
+    o.clear();
+  }
+
+  iterator erase(iterator pos) {
+    std::move(pos + 1, end(), pos);
+    pop_back();
+    return pos;
+  }
+
+  void clear() {
+    std::destroy(begin(), end());
+    length = 0;
+  }
+
+  void reserve(std::size_t n) {
+    if (n > capacity) {
+      grow(std::max(n, capacity * 2));
+    }
+  }
+
+ private:
+  T* inlineData() { return reinterpret_cast<T*>(storage); }
+  const T* inlineData() const { return reinterpret_cast<const T*>(storage); }
+
+  void grow(std::size_t n) {
+    auto p = static_cast<T*>(std::malloc(n * sizeof(T)));
+    if (p == nullptr) {
+      throw std::bad_alloc();
+    }
+    std::uninitialized_move(begin(), end(), p);
+    std::destroy(begin(), end());
+    if (!isInline()) {
+      std::free(data);
+    }
+    data = p;
+    capacity = n;
+  }
+
+  void destroy() {
+    clear();
+    if (!isInline()) {
+      std::free(data);
+    }
+    data = inlineData();
+    capacity = N;
+  }
+
+  // leaves o empty and inline
+  void take(SmallVector& o) {
+    if (o.isInline()) {
+      std::uninitialized_move(o.begin(), o.end(), data);
+      length = o.length;
+      o.clear();
+      return;
+    }
+    data = o.data;
+    length = o.length;
+    capacity = o.capacity;
+    o.data = o.inlineData();
+    o.length = 0;
+    o.capacity = N;
+  }
+
+  T* data = inlineData();
+  std::size_t length = 0;
+  std::size_t capacity = N;
+  alignas(T) unsigned char storage[N * sizeof(T)];
+};
+
+} // namespace lx
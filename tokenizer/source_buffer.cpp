@@ -0,0 +1,76 @@
+#include "source_buffer.h"
+
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace lx;
+
+SourceBuffer::SourceBuffer(const std::string& fileName) {
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return; // same as an unreadable ifstream: empty input
+  }
+  struct stat st{};
+  if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    void* p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p != MAP_FAILED) {
+      ::madvise(p, st.st_size, MADV_SEQUENTIAL);
+      data = static_cast<const char*>(p);
+      length = st.st_size;
+      mapped = true;
+      ::close(fd);
+      return;
+    }
+  }
+  readAll(fd);
+  ::close(fd);
+}
+
+void SourceBuffer::readAll(int fd) {
+  const std::size_t chunk = 1 << 16;
+  std::size_t used = 0;
+  while (true) {
+    storage.resize(used + chunk);
+    auto n = ::read(fd, storage.data() + used, chunk);
+    if (n <= 0) {
+      break;
+    }
+    used += n;
+  }
+  storage.resize(used);
+  data = storage.data();
+  length = used;
+}
+
+SourceBuffer::SourceBuffer(SourceBuffer&& o) noexcept {
+  *this = std::move(o);
+}
+
+SourceBuffer& SourceBuffer::operator=(SourceBuffer&& o) noexcept {
+  if (this != &o) {
+    release();
+    mapped = o.mapped;
+    length = o.length;
+    storage = std::move(o.storage);
+    data = mapped ? o.data : storage.data();
+    o.data = nullptr;
+    o.length = 0;
+    o.mapped = false;
+  }
+  return *this;
+}
+
+SourceBuffer::~SourceBuffer() { release(); }
+
+void SourceBuffer::release() {
+  if (mapped) {
+    ::munmap(const_cast<char*>(data), length);
+  }
+  data = nullptr;
+  length = 0;
+  mapped = false;
+  storage.clear();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace lx {
+
+// Whole input file in memory: mmap for regular files,
+// read() into a heap buffer for pipes and other streams.
+class SourceBuffer {
+ public:
+  SourceBuffer() = default;
+  explicit SourceBuffer(const std::string& fileName);
+  SourceBuffer(SourceBuffer&&) noexcept;
+  SourceBuffer& operator=(SourceBuffer&&) noexcept;
+  SourceBuffer(const SourceBuffer&) = delete;
+  SourceBuffer& operator=(const SourceBuffer&) = delete;
+  ~SourceBuffer();
+
+  const char* begin() const { return data; }
+  const char* end() const { return data + length; }
+  std::size_t size() const { return length; }
+  bool isMapped() const { return mapped; }
+
+ private:
+  void release();
+  void readAll(int fd);
+
+  const char* data = nullptr;
+  std::size_t length = 0;
+  bool mapped = false;
+  std::vector<char> storage;
+};
+
+} // namespace lx
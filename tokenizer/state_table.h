@@ -90,7 +90,7 @@
 #define CHANGE_BASE \
 {{std::make_pair(0,12),  2}, {std::make_pair(17,19), 2},\
 {std::make_pair(0, 1),  8}, {std::make_pair(17,21), 8},\
-{std::make_pair(0,14), 10}, {std::make_pair(17,19),10},\
+{std::make_pair(0,14), 10}, {std::make_pair(17,18),10},\
 {std::make_pair(0, 4), 16}, {std::make_pair(17,20),16}}\
 
 #define SKIP_SYMBOL {\
@@ -0,0 +1,27 @@
+#include "string_pool.h"
+
+#include <cstring>
+
+using namespace lx;
+
+std::string_view StringPool::store(std::string_view s) {
+  if (s.empty()) {
+    return {};
+  }
+  if (s.size() > left) {
+    if (s.size() > blockSize / 4) {
+      // long literal gets its own block, the current one keeps filling
+      blocks.emplace_back(new char[s.size()]);
+      std::memcpy(blocks.back().get(), s.data(), s.size());
+      return {blocks.back().get(), s.size()};
+    }
+    blocks.emplace_back(new char[blockSize]);
+    current = blocks.back().get();
+    left = blockSize;
+  }
+  std::memcpy(current, s.data(), s.size());
+  std::string_view r(current, s.size());
+  current += s.size();
+  left -= s.size();
+  return r;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace lx {
+
+// Append-only storage for token text that is not a verbatim slice of the
+// source: folded keywords, strings with '' or #nn, stream input.
+// Views returned by store() live as long as the pool.
+class StringPool {
+ public:
+  std::string_view store(std::string_view);
+
+ private:
+  static constexpr std::size_t blockSize = 1 << 16;
+
+  std::vector<std::unique_ptr<char[]>> blocks;
+  char* current = nullptr;
+  std::size_t left = 0;
+};
+
+} // namespace lx
@@ -8,43 +8,58 @@ std::string getPoint(int line, int column, std::string sep) {
 }
 
 std::string getPoint(const Token& t, std::string sep) {
-	return getPoint(t.getLine(), t.getColumn(), std::move(sep));
+	auto at = t.getPosition();
+	return getPoint(at.line, at.column, std::move(sep));
 }
 
-Token::Token(int line, int column,
-					   TokenType tokenType, const std::string& strValue)
-    : line(line), column(column),
+lx::Position SourcePoint::get() const {
+  if (lines) {
+    return lines->locate(offset);
+  }
+  return {line, column};
+}
+
+Token::Token(SourcePoint point,
+					   TokenType tokenType, std::string_view strValue)
+    : point(point),
       tokenType(tokenType),
       strValue(strValue),
       value(strValue) {}
 
-Token::Token(int line, int column, TokenType tokenType)
-    : Token(line, column, tokenType, toString(tokenType)) {}
+Token::Token(SourcePoint point, TokenType tokenType)
+    : Token(point, tokenType, getSpelling(tokenType)) {}
 
-Token::Token(int line, int column,
-						 uint64_t value, const std::string& strValue)
-		: line(line), column(column),
+Token::Token(SourcePoint point,
+						 uint64_t value, std::string_view strValue)
+		: point(point),
 			tokenType(TokenType::Int),
 			strValue(strValue),
 			value(value) {}
 
-Token::Token(int line, int column,
-						 long double value, const std::string& strValue)
-		: line(line), column(column),
+Token::Token(SourcePoint point,
+						 long double value, std::string_view strValue)
+		: point(point),
 			tokenType(TokenType::Double),
 			strValue(strValue),
 			value(value) {}
 
-Token::Token(int line, int column,
+Token::Token(SourcePoint point,
 						 TokenType tokenType,
-						 const std::string& value,
-						 const std::string& strValue)
-		: line(line), column(column),
+						 std::string_view value,
+						 std::string_view strValue)
+		: point(point),
 			tokenType(tokenType),
 			strValue(strValue),
 			value(value) {}
 
 
+Token::Token(SourcePoint point, Atom id, std::string_view strValue)
+		: point(point),
+			tokenType(TokenType::Id),
+			atom(id),
+			strValue(strValue),
+			value(std::string_view(id.str())) {}
+
 uint64_t Token::getInt() const {
 	return std::get<uint64_t>(value);
 }
@@ -62,13 +77,13 @@ std::string Token::getString() const {
 			overloaded{
 					[](uint64_t arg) { return std::to_string(arg); },
 					[](long double arg) { return std::to_string(arg); },
-					[](std::string arg) { return arg; },},
+					[](std::string_view arg) { return std::string(arg); },},
 			value);
 }
 
 std::string Token::getTestLine() const {
 	return getPoint(*this, "\t") +
 				 getGroup(tokenType) + "\t" +
-				 "\"" + strValue + "\"\t\t" +
+				 "\"" + std::string(strValue) + "\"\t\t" +
 				 "\"" + getString() + "\"";
 }
\ No newline at end of file
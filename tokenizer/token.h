@@ -1,42 +1,76 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <stdexcept>
-#include <list>
 #include <variant>
 
 #include "token_type.h"
+#include "atom.h"
+#include "line_table.h"
+#include "small_vector.h"
+
+// Where a token starts. A token of a source buffer keeps its offset and the
+// line table of the buffer, line and column are looked up only when a
+// diagnostic or a test line asks for them. Stream mode counts them as it
+// reads, tokens made up by the passes have none and report -1, -1.
+class SourcePoint {
+ public:
+  SourcePoint() = default;
+  SourcePoint(const lx::LineTable& lines, std::size_t offset)
+    : lines(&lines), offset(static_cast<uint32_t>(offset)) {}
+  SourcePoint(int line, int column) : line(line), column(column) {}
+
+  lx::Position get() const;
+
+ private:
+  const lx::LineTable* lines = nullptr;
+  // offset with a line table, line and column without one
+  union {
+    uint32_t offset;
+    int line = -1;
+  };
+  int column = -1;
+};
 
 class Token {
  public:
 	Token() = delete;
-	Token(int line, int column, TokenType);
-	Token(int line, int column, TokenType, const std::string& strValue);
-	Token(int line, int column, uint64_t, const std::string& strValue);
-	Token(int line, int column, long double, const std::string& strValue);
-	Token(int line, int column, TokenType, const std::string& value,
-				const std::string& strValue);
+	Token(SourcePoint, TokenType);
+	Token(SourcePoint, TokenType, std::string_view strValue);
+	Token(SourcePoint, uint64_t, std::string_view strValue);
+	Token(SourcePoint, long double, std::string_view strValue);
+	Token(SourcePoint, TokenType, std::string_view value,
+				std::string_view strValue);
+	Token(SourcePoint, Atom id, std::string_view strValue);
 
   std::string getTestLine() const;
 
-  int getLine() const { return line; }
-  int getColumn() const { return column; }
-  std::string getStrValue() const { return strValue; }
+  int getLine() const { return point.get().line; }
+  int getColumn() const { return point.get().column; }
+  lx::Position getPosition() const { return point.get(); }
+  std::string_view getStrValue() const { return strValue; }
   TokenType getTokenType() const { return tokenType; }
+  Atom getAtom() const { return atom; }
 	bool is(TokenType t) const { return tokenType == t; }
 
   uint64_t getInt() const;
   long double getDouble() const;
   std::string getString() const;
+  // value of a token that is neither Int nor Double
+  std::string_view getStringView() const { return std::get<std::string_view>(value); }
 
  private:
-  int line, column;
+  SourcePoint point;
   TokenType tokenType;
-  std::string strValue;
-	std::variant<long double, uint64_t, std::string> value;
+  Atom atom;
+  // views into the lexer source buffer or its string pool,
+  // a token must not outlive the lexer that produced it
+  std::string_view strValue;
+	std::variant<long double, uint64_t, std::string_view> value;
 };
 
-using ListToken = std::list<Token>;
+using ListToken = lx::SmallVector<Token, 4>;
 
 std::string getPoint(int line, int column, std::string sep = ",");
 std::string getPoint(const Token&, std::string sep = ",");
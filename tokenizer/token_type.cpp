@@ -20,17 +20,10 @@ std::string toString(TokenType t) {
 #undef MAKE_CASE_KEYWORD
 #undef MAKE_CASE_TOKEN
 
-// TODO replace to unborded map
-#define MAKE_LIST(E, S) {S, TokenType::E},
-static std::map<std::string, TokenType> mapKeyword({KEYWORD_TYPE(MAKE_LIST)});
-#undef MAKE_LIST
+#define MAKE_SPELLING(E, S) S,
+static constexpr std::string_view spelling[] = {TOKEN_TYPE(MAKE_SPELLING) KEYWORD_TYPE(MAKE_SPELLING)};
+#undef MAKE_SPELLING
 
-TokenType getKeywordType(const std::string& s) {
-  return mapKeyword.at(s);
+std::string_view getSpelling(TokenType t) {
+  return spelling[static_cast<int>(t)];
 }
-
-bool isKeyword(const std::string& s) {
-  return mapKeyword.count(s) > 0;
-}
-
-
@@ -1,7 +1,7 @@
 #pragma once
 
-#include <map>
 #include <string>
+#include <string_view>
 
 #define TOKEN_TYPE(X) \
   X(Int,                   "Int") \
@@ -90,8 +90,10 @@ enum class TokenType {
 };
 #undef MAKE_ENUM
 
+#define COUNT_ENUM(E, S) + 1
+constexpr int numTokenType = 0 TOKEN_TYPE(COUNT_ENUM) KEYWORD_TYPE(COUNT_ENUM);
+#undef COUNT_ENUM
+
 std::string getGroup(TokenType);
 std::string toString(TokenType);
-
-TokenType getKeywordType(const std::string&);
-bool isKeyword(const std::string&);
+std::string_view getSpelling(TokenType);